@@ -1,10 +1,39 @@
 #include <SDL.h>
 
 #define DUI_IMPLEMENTATION
+#define DUI_TRUETYPE
 #include <DUI/DUI.h>
 
+enum {
+    CHANNEL_WAVE,
+};
+
+// Publish a value and record a scope from a second thread
+int worker(void * data)
+{
+    SDL_atomic_t * running = (SDL_atomic_t *)data;
+    double t = 0.0;
+
+    while (SDL_AtomicGet(running)) {
+        DUI_ProfileBegin("WORKER");
+
+        DUI_ProfileBegin("WAVE");
+        DUI_ChannelPush(CHANNEL_WAVE, (float)SDL_sin(t));
+        t += 0.05;
+        DUI_ProfileEnd();
+
+        SDL_Delay(4);
+
+        DUI_ProfileEnd();
+    }
+
+    return 0;
+}
+
 int main(int argc, char ** argv)
 {
+    const char * fontPath = (argc > 1 ? argv[1] : "fonts/Anonymous_Pro.ttf");
+
     SDL_Init(SDL_INIT_VIDEO);
 
     SDL_Window * win = SDL_CreateWindow("DebugUI Demo",
@@ -36,6 +65,19 @@ int main(int argc, char ** argv)
     bool autoTick = false;
     int counter = 0;
 
+    DUI_Series * wave = DUI_CreateSeries(1024);
+    DUI_ChannelBind(CHANNEL_WAVE, wave);
+
+    SDL_atomic_t workerRunning;
+    SDL_AtomicSet(&workerRunning, 1);
+    SDL_Thread * workerThread = SDL_CreateThread(worker, "worker", &workerRunning);
+
+    bool fontLoaded = false;
+    bool fontSDF = false;
+    int fontHeight = 16;
+    int sdfWidth = 0;
+    int sdfHeight = 0;
+
     SDL_Event evt;
     bool running = true;
     while (running) {
@@ -47,6 +89,8 @@ int main(int argc, char ** argv)
 
         DUI_Update();
 
+        DUI_ProfileBegin("FRAME");
+
         SDL_SetRenderDrawColor(ren, 0x33, 0x33, 0x33, 0xFF);
         SDL_RenderClear(ren);
 
@@ -56,7 +100,7 @@ int main(int argc, char ** argv)
 
         if (DUI_Tab("TAB1", TAB1, &tabIndex)) {
             DUI_MoveCursor(8, 40);
-            DUI_Panel(800 - 16, 600 - 48);
+            DUI_PanelStart(NULL, 800 - 16, 600 - 48, true);
 
             DUI_Println("TAB #1");
             DUI_Newline();
@@ -84,36 +128,114 @@ int main(int argc, char ** argv)
             DUI_Radio("DECREMENT", DECREMENT, &incDecIndex);
             DUI_Newline();
             DUI_Newline();
+
+            DUI_PanelEnd();
         }
         
         if (DUI_Tab("TAB2", TAB2, &tabIndex)) {
             DUI_MoveCursor(8, 40);
-            DUI_Panel(800 - 16, 600 - 48);
+            DUI_PanelStart(NULL, 800 - 16, 600 - 48, true);
 
             DUI_Println("TAB #2");
             DUI_Newline();
+
+            // Each byte that isn't part of a UTF-8 character is drawn as U+FFFD
+            DUI_Println("UTF-8: CAF\xC3\x89");
+            DUI_Println("LATIN-1: 25\xB0" "C");
+
+            DUI_PanelEnd();
         }
         
         if (DUI_Tab("TAB3", TAB3, &tabIndex)) {
             DUI_MoveCursor(8, 40);
-            DUI_Panel(800 - 16, 600 - 48);
+            DUI_PanelStart(NULL, 800 - 16, 600 - 48, true);
 
             DUI_Println("TAB #3");
             DUI_Newline();
+
+            DUI_ProfilerPanel(800 - 48, 200, 4);
+            DUI_Newline();
+
+            size_t count = DUI_SeriesCount(wave);
+            DUI_PlotSeries("WAVE", wave, 0, count, 800 - 48, 100);
+            DUI_Println("DROPPED: %u", DUI_ChannelDropped());
+            DUI_Newline();
+
+            if (DUI_Button("DUMP")) {
+                DUI_ProfilerDump("trace.json");
+            }
+
+            DUI_PanelEnd();
         }
         
         if (DUI_Tab("TAB4", TAB4, &tabIndex)) {
             DUI_MoveCursor(8, 40);
-            DUI_Panel(800 - 16, 600 - 48);
+            DUI_PanelStart(NULL, 800 - 16, 600 - 48, true);
 
             DUI_Println("TAB #4");
             DUI_Newline();
+
+            int width, height;
+            DUI_MeasureText("MEASURED", &width, &height);
+            DUI_Println("MEASURED IS %dx%d", width, height);
+            DUI_Newline();
+
+            if (DUI_Button("TRUETYPE")) {
+                fontLoaded = DUI_LoadFont(fontPath, fontHeight, NULL);
+                fontSDF = false;
+            }
+
+            if (DUI_Button("SDF")) {
+                fontLoaded = DUI_LoadFontSDF(fontPath, fontHeight, NULL);
+                fontSDF = fontLoaded;
+                sdfWidth = DUI_GetStyle()->CharWidth;
+                sdfHeight = fontHeight;
+            }
+
+            DUI_Newline();
+            DUI_Newline();
+
+            int zoom = 0;
+            if (DUI_Button("SMALLER") && fontHeight > 8) {
+                zoom = -4;
+            }
+
+            if (DUI_Button("LARGER") && fontHeight < 64) {
+                zoom = 4;
+            }
+
+            fontHeight += zoom;
+
+            // An SDF font is drawn at any size without rasterizing again
+            if (zoom != 0 && fontSDF) {
+                DUI_Style * style = DUI_GetStyle();
+                style->CharWidth = SDL_max(sdfWidth * fontHeight / sdfHeight, 1);
+                style->CharHeight = fontHeight;
+            }
+
+            DUI_Newline();
+            DUI_Newline();
+
+            DUI_Println("%s AT %d PIXELS", (fontLoaded ? fontPath : "BUILT-IN FONT"), fontHeight);
+
+            DUI_PanelEnd();
         }
 
+        DUI_ProfileBegin("RENDER");
+        DUI_Render();
+        DUI_ProfileEnd();
+
+        DUI_ProfileEnd();
+
         SDL_RenderPresent(ren);
     }
 
+    SDL_AtomicSet(&workerRunning, 0);
+    SDL_WaitThread(workerThread, NULL);
+
     DUI_Term();
 
+    DUI_DestroySeries(wave);
+
     return 0;
 }
\ No newline at end of file
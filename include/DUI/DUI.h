@@ -51,11 +51,129 @@ typedef struct
 
 } DUI_Style;
 
+typedef enum
+{
+    DUI_LAYER_DEFAULT,
+    DUI_LAYER_OVERLAY,
+
+    DUI_LAYER_COUNT,
+
+} DUI_Layer;
+
+typedef enum
+{
+    // The panel will not grow to fit its contents
+    DUI_PANEL_FIXED     = (1 << 0),
+
+    // Draw the panel's contents into a render target, instead of clipping 
+    //   them while drawing into the parent's target
+    DUI_PANEL_OFFSCREEN = (1 << 1),
+
+} DUI_PanelFlags;
+
+typedef struct
+{
+    uint64_t Hits;
+    uint64_t Misses;
+    uint64_t Evictions;
+
+    // The memory used by the cache's textures, in bytes
+    size_t Bytes;
+
+} DUI_CacheStats;
+
+typedef struct
+{
+    // Buttons, checkboxes, radio buttons, tabs, plots and histograms
+    uint32_t Widgets;
+    uint32_t Panels;
+    uint32_t Commands;
+
+    // Glyph quads drawn, a line from the text cache is one quad
+    uint32_t Glyphs;
+
+    // Calls to SDL_RenderFillRects, SDL_RenderDrawRects, and SDL_RenderDrawLines
+    uint32_t FillCalls;
+    uint32_t OutlineCalls;
+    uint32_t LineCalls;
+
+    // Calls to SDL_RenderCopy and SDL_RenderGeometry
+    uint32_t CopyCalls;
+    uint32_t GeometryCalls;
+
+    uint32_t TargetSwitches;
+
+    // The length of the text formatted by DUI_Print
+    uint64_t BytesFormatted;
+
+    // Time spent in DUI_Print and DUI_Render, in milliseconds
+    double PrintTime;
+    double RenderTime;
+
+} DUI_Stats;
+
+// A ring buffer of samples, created with DUI_CreateSeries
+typedef struct DUI_Series DUI_Series;
+
+// A ring buffer of lines of text, created with DUI_CreateConsole
+typedef struct DUI_Console DUI_Console;
+
+typedef struct
+{
+    float Min;
+    float Max;
+    float Mean;
+
+} DUI_SeriesBucket;
+
+typedef enum
+{
+    // Buckets are evenly sized
+    DUI_HISTOGRAM_LINEAR,
+
+    // Buckets grow exponentially, each covering the same ratio of values
+    DUI_HISTOGRAM_LOG,
+
+} DUI_HistogramScale;
+
+typedef struct
+{
+    // The index of the parent node, or -1 for a root node
+    int Parent;
+
+    const char * Name;
+
+    // Time spent in this node, excluding and including its children
+    uint64_t SelfTicks;
+    uint64_t TotalTicks;
+
+} DUI_FlameNode;
+
+typedef struct
+{
+    // The texture containing the glyph, NULL for characters that draw nothing
+    SDL_Texture * Texture;
+
+    // The area of Texture containing the glyph
+    SDL_Rect Src;
+
+    // The part of the character's cell the glyph is drawn to, as fractions
+    //   of the cell's width and height. A Width of 0 fills the whole cell
+    float Left;
+    float Top;
+    float Width;
+    float Height;
+
+} DUI_Glyph;
+
 /* Initialize the Debug UI.
  *
  * @param window: The SDL window to draw to. This will be used
  *   to get the SDL_Renderer for drawing, and the WindowID for
  *   determining which events are relevant. 
+ *
+ * An event watch is added to track the size of the window, resizes are
+ *   applied by the next call to DUI_Update.
  */
 void DUI_Init(SDL_Window * window);
 
@@ -68,9 +186,92 @@ void DUI_Term();
 void DUI_Update();
 
 /* Render DUI Foreground and Overlay, call at the end of every frame.
+ *
+ * Widgets do not draw immediately, they record commands to a draw list.
+ * This sorts the list by layer, and submits it to the SDL Renderer's
+ *   current render target in one pass, then clears it for the next frame.
  */
 void DUI_Render();
 
+/* Enable or disable retained rendering, disabled by default.
+ *
+ * When enabled, DUI_Render draws into a texture that is kept between frames,
+ *   and then copies that texture to the render target. If nothing drawn by 
+ *   DUI changed since the previous frame, drawing is skipped and the 
+ *   previous frame's texture is copied again.
+ *
+ * @param retained: True to enable retained rendering.
+ */
+void DUI_SetRetained(bool retained);
+
+/* Set the maximum number of rectangles redrawn when a retained frame changes.
+ *
+ * Commands are compared with the previous frame, and only the areas 
+ *   covered by commands that were added, removed, or changed are cleared
+ *   and drawn again. When more areas than this change, they are merged.
+ *
+ * @param count: The maximum number of dirty rectangles, 0 to always
+ *   redraw the whole frame.
+ */
+void DUI_SetMaxDirtyRects(int count);
+
+/* Get the number of frames that reused the retained texture (Hits), and the
+ *   number of frames that had to be drawn again (Misses).
+ *
+ * @return: The retained rendering statistics.
+ */
+DUI_CacheStats DUI_GetRetainedStats();
+
+/* Set the amount of texture memory used to cache lines of text.
+ *
+ * Lines that are drawn on more than one frame are drawn once into a
+ *   texture, then copied from it with a single quad. When the cache is
+ *   full, the least recently used texture is cleared.
+ *
+ * @param bytes: The maximum size of the cache, 0 to disable it.
+ */
+void DUI_SetTextCacheBudget(size_t bytes);
+
+/* Get the number of lines of text drawn from the cache (Hits), the number
+ *   drawn character by character (Misses), and the number of lines removed
+ *   to make room for others (Evictions).
+ *
+ * @return: The text cache statistics.
+ */
+DUI_CacheStats DUI_GetTextCacheStats();
+
+/* Get the number of SDL state changes that were skipped because the state 
+ *   was already set (Hits), and the number that were made (Misses).
+ *
+ * This covers the draw color, blend mode, render target and clip rect.
+ *
+ * @return: The render state cache statistics.
+ */
+DUI_CacheStats DUI_GetRenderStateStats();
+
+/* Get the work done by DUI in the previous frame, from the first call 
+ *   after DUI_Render until the end of the next DUI_Render.
+ *
+ * @return: The statistics for the previous frame.
+ */
+DUI_Stats DUI_GetStats();
+
+/* Show or hide the performance HUD in the top right corner of the window.
+ *
+ * The HUD shows the frame rate, a graph of recent frame times, the time 
+ *   spent in DUI, and the statistics from DUI_GetStats. 
+ * It is drawn into a texture of its own, which is redrawn at most 
+ *   updatesPerSecond times per second, and copied over everything else
+ *   by DUI_Render on every frame. The work done to draw the HUD is not
+ *   included in DUI_GetStats.
+ *
+ * @param enabled: True to show the HUD.
+ *
+ * @param updatesPerSecond: The rate to redraw the HUD at, or 0 for 
+ *   DUI_PERF_HUD_RATE.
+ */
+void DUI_SetPerfHUD(bool enabled, float updatesPerSecond);
+
 /* Set the style.
  *
  * @param style: The DUI_Style to use
@@ -83,26 +284,146 @@ void DUI_SetStyle(DUI_Style style);
  */
 DUI_Style * DUI_GetStyle();
 
-/* Set the Render Draw Color of the SDL Renderer to the
+/* Set the color of future draw commands to the
  *  color specified in Style.ColorBackground.
  */
 void DUI_SetColorBackground();
 
-/* Set the Render Draw Color of the SDL Renderer to the
+/* Set the color of future draw commands to the
  *  color specified in Style.ColorBorder.
  */
 void DUI_SetColorBorder();
 
-/* Set the Render Draw Color of the SDL Renderer to the
+/* Set the color of future draw commands to the
  *  color specified in Style.ColorHover.
  */
 void DUI_SetColorHover();
 
-/* Set the Render Draw Color of the SDL Renderer to the
+/* Set the color of future draw commands to the
  *  color specified in Style.ColorDefault.
  */
 void DUI_SetColorDefault();
 
+/* Set the layer that future draw commands are recorded to.
+ *
+ * Commands are drawn in the order they were recorded, except that
+ *   every command on DUI_LAYER_OVERLAY is drawn after (on top of) every
+ *   command on DUI_LAYER_DEFAULT.
+ *
+ * @param layer: The DUI_Layer to use.
+ */
+void DUI_SetLayer(DUI_Layer layer);
+
+/* Get the glyph used to draw a character.
+ *
+ * Characters missing from the font use the glyph for '?'.
+ *
+ * @param codepoint: The character to look up.
+ *
+ * @return: The glyph for the character.
+ */
+const DUI_Glyph * DUI_GetGlyph(uint32_t codepoint);
+
+/* Add or replace the glyph used to draw a character.
+ *
+ * Text is decoded as UTF-8, and each character is drawn with the glyph 
+ *   for its codepoint. The built-in fonts only cover ASCII, other 
+ *   characters can be added with this, or with DUI_AddGlyphPage.
+ *
+ * @param codepoint: The character, at most 0x10FFFF.
+ *
+ * @param texture: The texture containing the glyph, or NULL for a character
+ *   that draws nothing. It must remain valid until the glyph is replaced,
+ *   or DUI_Term is called. The glyph is kept when a font is loaded.
+ *
+ * @param src: The area of texture containing the glyph, which is stretched 
+ *   to CharWidth by the height of the line.
+ *
+ * @return: False if the codepoint is out of range, or memory could not be
+ *   allocated.
+ */
+bool DUI_AddGlyph(uint32_t codepoint, SDL_Texture * texture, const SDL_Rect * src);
+
+/* Add glyphs from an image divided into a grid of equally sized cells.
+ *
+ * The image is copied into a texture owned by DUI, which is destroyed
+ *   by DUI_Term.
+ *
+ * @param surface: The image containing the glyphs, it can be freed after
+ *   this returns.
+ *
+ * @param cellWidth: The width of each cell.
+ *
+ * @param cellHeight: The height of each cell.
+ *
+ * @param codepoints: The character drawn in each cell, from left to right 
+ *   then top to bottom, or 0 to skip a cell.
+ *
+ * @param count: The number of values in codepoints.
+ *
+ * @return: False if the cells are empty or wider than the image, the texture
+ *   could not be created, or memory could not be allocated.
+ */
+bool DUI_AddGlyphPage(SDL_Surface * surface, int cellWidth, int cellHeight, 
+    const uint32_t * codepoints, size_t count);
+
+#if defined(DUI_TRUETYPE)
+
+/* Draw text with a TrueType font instead of the built-in bitmap font.
+ *
+ * Call this after DUI_Init. Glyphs are rasterized at the given size the
+ *   first time each character is drawn, and packed into atlas textures.
+ *   CharWidth and CharHeight are set to the size of the font's cells, so
+ *   text is drawn without stretching. Call this again to change the size,
+ *   such as when the window moves to a display with a different DPI.
+ *
+ * @param path: The path of the font file, such as fonts/Anonymous_Pro.ttf.
+ *   Every character is given the advance width of the space character, 
+ *   so the font should be monospaced.
+ *
+ * @param pixelHeight: The height of a line of text, in pixels.
+ *
+ * @param cachePath: Optional, the path of a file to keep rasterized glyphs
+ *   in. If it was written for the same font and size, its glyphs are 
+ *   loaded instead of being rasterized again. It is written by DUI_Term, 
+ *   or the next call to DUI_LoadFont, if any glyphs were added.
+ *
+ * @return: False if the font could not be loaded, in which case the 
+ *   built-in font is used.
+ */
+bool DUI_LoadFont(const char * path, int pixelHeight, const char * cachePath);
+
+/* Draw text with a TrueType font, from a signed distance field atlas.
+ *
+ * Call this after DUI_Init. Every glyph in the font is rasterized once, 
+ *   as the distance to its outline, across several threads. The same atlas
+ *   draws text at any size, so CharWidth and CharHeight can be changed at 
+ *   any time without rasterizing again, such as to zoom in.
+ *
+ * The edges of the glyphs are sharpened for the CharHeight they are drawn
+ *   at, rounded to one of four steps per power of two, such as 16, 20, 24.
+ *   The first time a page of the atlas is drawn at a new step it is 
+ *   converted into a texture of up to 1MB, which is kept for the most 
+ *   recent DUI_FONT_MAX_RAMPS steps, so zooming back and forth is free.
+ *
+ * @param path: The path of the font file, such as fonts/Anonymous_Pro.ttf.
+ *   The font should be monospaced.
+ *
+ * @param pixelHeight: The height of a line of text, in pixels. CharWidth 
+ *   and CharHeight are set to fit it.
+ *
+ * @param cachePath: Optional, the path of a file to keep the atlas in. If it
+ *   was written for the same font, it is loaded instead of rasterizing 
+ *   the glyphs again. It is written by DUI_Term, or the next call to 
+ *   DUI_LoadFont or DUI_LoadFontSDF, if it was not loaded.
+ *
+ * @return: False if the font could not be loaded, in which case the 
+ *   built-in font is used.
+ */
+bool DUI_LoadFontSDF(const char * path, int pixelHeight, const char * cachePath);
+
+#endif // DUI_TRUETYPE
+
 /* Move the DUI cursor.
  *
  * @param x: The new x coordinate. This will be used as the start
@@ -172,6 +493,36 @@ void DUI_Print(const char * format, ...);
         DUI_MoveCursor(tmpX, tmpY);         \
     } while (0)
 
+/* Measure the area text would cover if printed with the current style.
+ *
+ * The width is that of the longest line, and the height includes the 
+ *   LinePadding between lines.
+ *
+ * @param text: The text to measure.
+ *
+ * @param width: Optional, set to the width of the text.
+ *
+ * @param height: Optional, set to the height of the text.
+ */
+void DUI_MeasureText(const char * text, int * width, int * height);
+
+/* Format text and measure it, behaves like DUI_MeasureText.
+ *
+ * The formatted text is returned, so it can be printed without formatting
+ *   it again, such as to right align a value:
+ *   const char * text = DUI_MeasureTextf(&w, NULL, "%d", value);
+ *   DUI_PrintAt(right - w, y, "%s", text);
+ *
+ * @param width: Optional, set to the width of the text.
+ *
+ * @param height: Optional, set to the height of the text.
+ *
+ * @param format: The format string to pass to vsnprintf.
+ *
+ * @return: The formatted text, valid until the next call.
+ */
+const char * DUI_MeasureTextf(int * width, int * height, const char * format, ...);
+
 /* Store the current panel title, and minimum size
  *
  * Always call DUI_PanelEnd() after calling this.
@@ -186,6 +537,25 @@ void DUI_Print(const char * format, ...);
  */
 void DUI_PanelStart(const char * title, int width, int height, bool fixed);
 
+/* Store the current panel title, minimum size, and flags
+ *
+ * Always call DUI_PanelEnd() after calling this.
+ *
+ * By default, the panel's contents are drawn directly into the parent's 
+ *   render target, clipped to the panel's bounds. Set DUI_PANEL_OFFSCREEN
+ *   to draw them into a render target of their own instead, which is then
+ *   copied into the parent.
+ * 
+ * @param title: Optional title to display in the panel.
+ *
+ * @param width: The minimum width of the panel to draw.
+ *
+ * @param height: The minimum height of the panel to draw.
+ * 
+ * @param flags: A combination of DUI_PanelFlags.
+ */
+void DUI_PanelStartEx(const char * title, int width, int height, int flags);
+
 /* Draw the current panel outline and title, then discard the
  *   current panel information.
  * 
@@ -335,518 +705,6131 @@ void DUI_BeginTabBar();
  */
 bool DUI_Tab(const char * text, int index, int * currentIndex);
 
-#endif // DUI_H
-
-#if defined(DUI_IMPLEMENTATION)
+/* Draw a line plot of a series of values.
+ *
+ * The values are scaled to fit between the minimum and maximum value.
+ * When there are more values than pixels, each column of pixels is
+ *   reduced to the minimum and maximum of the values it covers, so
+ *   spikes are kept. The line is drawn with a single call.
+ * The border and the line will be drawn with ColorBorder.
+ * The background will be filled with ColorDefault.
+ * The cursor will be moved to the next line, below the plot.
+ *
+ * @param label: Optional text to draw in the top left of the plot, 
+ *   followed by the range of the values.
+ *
+ * @param data: The values to plot.
+ *
+ * @param count: The number of values in data.
+ *
+ * @param width: The width of the plot.
+ *
+ * @param height: The height of the plot.
+ */
+void DUI_PlotLines(const char * label, const float * data, size_t count, int width, int height);
 
-#if defined(DUI_FONT_ANONYMOUS)
-#   include <DUI/DUI_FontAnonymous.h>
-#else
-#   include <DUI/DUI_FontGB.h>
-#endif
+/* Create a series of samples, to be drawn with DUI_PlotSeries.
+ *
+ * The most recent samples are kept in a ring buffer, along with the 
+ *   minimum, maximum and mean of every 2, 4, 8, etc. samples, so that
+ *   any range can be summarized in time proportional to the number of 
+ *   columns drawn rather than the number of samples.
+ * Nothing is allocated after creation.
+ *
+ * @param capacity: The number of samples to keep, rounded up to a power of two.
+ *
+ * @return: The new series, or NULL if it could not be allocated.
+ */
+DUI_Series * DUI_CreateSeries(size_t capacity);
 
-SDL_Window *   _duiWindow      = NULL;
-SDL_Renderer * _duiRenderer    = NULL;
-SDL_Texture *  _duiFontTexture = NULL;
+/* Destroy a series created with DUI_CreateSeries.
+ */
+void DUI_DestroySeries(DUI_Series * series);
 
-int _duiWindowID = 0;
+/* Append a sample to a series, replacing the oldest sample if it is full.
+ *
+ * @param series: The series to append to.
+ *
+ * @param value: The sample.
+ */
+void DUI_SeriesAppend(DUI_Series * series, float value);
 
-typedef struct
-{
-    bool Fixed;
-    SDL_Rect Bounds;
-    const char * Title;
-    SDL_Texture * Texture;
+/* Get the number of samples currently in a series.
+ *
+ * @param series: The series.
+ *
+ * @return: The number of samples, at most the capacity of the series.
+ */
+size_t DUI_SeriesCount(const DUI_Series * series);
 
-} DUI_PanelInfo;
+/* Summarize a range of samples as a number of evenly sized buckets.
+ *
+ * @param series: The series.
+ *
+ * @param first: The index of the first sample, 0 is the oldest sample.
+ *
+ * @param count: The number of samples.
+ *
+ * @param buckets: The array to fill.
+ *
+ * @param bucketCount: The number of buckets to split the range into.
+ *
+ * @return: The number of buckets filled, fewer if the range holds fewer samples.
+ */
+size_t DUI_SeriesQuery(const DUI_Series * series, size_t first, size_t count, 
+    DUI_SeriesBucket * buckets, size_t bucketCount);
 
-#ifndef DUI_PANEL_STACK_DEPTH
-#   define DUI_PANEL_STACK_DEPTH (10)
-#endif // DUI_PANEL_STACK_DEPTH
+/* Draw a line plot of a range of samples from a series.
+ *
+ * Behaves like DUI_PlotLines.
+ *
+ * @param label: Optional text to draw in the top left of the plot, 
+ *   followed by the range of the values.
+ *
+ * @param series: The series.
+ *
+ * @param first: The index of the first sample, 0 is the oldest sample.
+ *
+ * @param count: The number of samples.
+ *
+ * @param width: The width of the plot.
+ *
+ * @param height: The height of the plot.
+ */
+void DUI_PlotSeries(const char * label, const DUI_Series * series, size_t first, size_t count, 
+    int width, int height);
 
-DUI_PanelInfo _duiPanelStack[DUI_PANEL_STACK_DEPTH + 1];
-int _duiPanelStackIndex = 0;
+/* Draw a histogram of a set of samples.
+ *
+ * Samples outside of the range are counted in the first or last bucket.
+ * The border will be drawn with ColorBorder.
+ * The background will be filled with ColorDefault, and the bars with
+ *   ColorHover.
+ * Hovering over a bar shows its range and count after the label.
+ * The cursor will be moved to the next line, below the histogram.
+ *
+ * @param label: Optional text to draw in the top left of the histogram.
+ *
+ * @param data: The samples.
+ *
+ * @param count: The number of samples.
+ *
+ * @param buckets: The number of buckets to sort the samples into.
+ *
+ * @param minimum: The lower bound of the first bucket.
+ *
+ * @param maximum: The upper bound of the last bucket. If this is not 
+ *   greater than minimum, the range of the samples is used instead. With 
+ *   DUI_HISTOGRAM_LOG, this range is limited to six orders of magnitude.
+ *
+ * @param scale: How the range is divided into buckets. With
+ *   DUI_HISTOGRAM_LOG, samples must be greater than zero.
+ *
+ * @param width: The width of the histogram.
+ *
+ * @param height: The height of the histogram.
+ */
+void DUI_Histogram(const char * label, const float * data, size_t count, int buckets,
+    float minimum, float maximum, DUI_HistogramScale scale, int width, int height);
 
-SDL_Texture * _duiOverlayTexture = NULL;
+/* Draw a flame graph of a tree of nodes, such as sampled call stacks.
+ *
+ * Root nodes are drawn along the top, and each node's children beneath it,
+ *   in the order they appear in the array, with a width proportional to
+ *   their TotalTicks. Names are cut off to fit. Nodes narrower than a pixel
+ *   are not drawn, along with their children.
+ * Hovering over a node shows its name and ticks on DUI_LAYER_OVERLAY.
+ * Clicking a node zooms in so it fills the width, clicking it again
+ *   zooms out to its parent.
+ * The cursor will be moved to the next line, below the graph.
+ *
+ * @param label: Optional text to draw above the graph.
+ *
+ * @param nodes: The nodes of the tree.
+ *
+ * @param count: The number of nodes.
+ *
+ * @param zoom: A pointer to the index of the node that fills the width, 
+ *   or -1 to show every root node. Updated when a node is clicked.
+ *
+ * @param width: The width of the graph.
+ *
+ * @param height: The height of the graph.
+ */
+void DUI_FlameGraph(const char * label, const DUI_FlameNode * nodes, size_t count, int * zoom, 
+    int width, int height);
 
-DUI_Style _duiStyle = {
-    .CharWidth = DUI_FONT_CHAR_WIDTH,
-    .CharHeight = DUI_FONT_CHAR_HEIGHT,
+/* Begin a profiling scope on the calling thread.
+ *
+ * The current time is recorded into a fixed size ring buffer belonging to
+ *   the thread, without locking or allocating. Scopes can be nested, and
+ *   can be used from any thread.
+ *
+ * Always call DUI_ProfileEnd() on the same thread after calling this.
+ *
+ * @param name: The name of the scope. This is stored, not copied, so it
+ *   must remain valid, such as a string literal.
+ */
+void DUI_ProfileBegin(const char * name);
 
-    .LinePadding = 4,
+/* End the most recent profiling scope on the calling thread.
+ */
+void DUI_ProfileEnd();
 
-    .PanelPadding = 8,
+/* Draw the scopes recorded over the last few frames as a timeline, inside
+ *   a fixed size panel.
+ *
+ * Each thread gets a row of bars, nested scopes are drawn beneath the
+ *   scope that contains them. Frames begin at each call to DUI_Update.
+ * Hovering over a bar shows its name and duration.
+ *
+ * @param width: The width of the timeline.
+ *
+ * @param height: The height of the timeline.
+ *
+ * @param frames: The number of frames to show.
+ */
+void DUI_ProfilerPanel(int width, int height, int frames);
 
-    .ButtonPadding = 4,
-    .ButtonMargin  = 8,
+/* Write the scopes recorded by every thread to a file, in the Chrome 
+ *   trace event format read by chrome://tracing and Perfetto.
+ *
+ * The recorded scopes are copied, and then formatted and written by a 
+ *   background thread, so this returns without waiting for the file. 
+ *   Frames are marked at each call to DUI_Update.
+ * Scopes that have not ended are written as ending now.
+ *
+ * This can be called from a button, such as:
+ *   if (DUI_Button("DUMP")) DUI_ProfilerDump("trace.json");
+ * or define DUI_PROFILE_DUMP_KEY to an SDL_Scancode to dump to 
+ *   DUI_PROFILE_DUMP_PATH whenever that key is pressed.
+ *
+ * @param path: The path of the file to write.
+ *
+ * @return: False if a previous dump is still being written, or the scopes
+ *   could not be copied.
+ */
+bool DUI_ProfilerDump(const char * path);
 
-    .TabPadding = 8,
-    .TabMargin  = 8,
+/* Publish a value from any thread, to be collected by the next DUI_Update.
+ *
+ * Each thread that calls this claims a queue of its own, which only that
+ *   thread writes to and only DUI_Update reads from, so threads never wait
+ *   on each other. A thread keeps its queue for the life of the program.
+ *
+ * @param id: An identifier chosen by the application, see DUI_ChannelBind.
+ *
+ * @param value: The value to publish.
+ *
+ * @return: False if the value was dropped, because the thread's queue is 
+ *   full or there are no queues left.
+ */
+bool DUI_ChannelPush(uint32_t id, float value);
 
-    .ColorBackground = { 0xEE, 0xEE, 0xEE, 0xFF },
-    .ColorBorder     = { 0x00, 0x00, 0x00, 0xFF },
-    .ColorHover      = { 0xEE, 0xEE, 0xEE, 0xEE },
+/* Append every value published with an id to a series.
+ *
+ * Values are appended in the order each thread published them. Values
+ *   published with an id that isn't bound are discarded.
+ *
+ * @param id: The identifier passed to DUI_ChannelPush.
+ *
+ * @param series: The series to append to, or NULL to only keep the latest
+ *   value for DUI_ChannelLatest.
+ *
+ * @return: False if too many ids are bound.
+ */
+bool DUI_ChannelBind(uint32_t id, DUI_Series * series);
+
+/* Get the most recent value published with a bound id.
+ *
+ * @param id: The identifier passed to DUI_ChannelPush and DUI_ChannelBind.
+ *
+ * @param value: Set to the value.
+ *
+ * @param timestamp: Optional, set to SDL_GetPerformanceCounter() at the 
+ *   time the value was published.
+ *
+ * @return: False if no value has been collected for the id.
+ */
+bool DUI_ChannelLatest(uint32_t id, float * value, uint64_t * timestamp);
+
+/* Get the number of values dropped because a queue was full.
+ *
+ * @return: The total number of values dropped, which wraps around like
+ *   any other uint32_t counter.
+ */
+uint32_t DUI_ChannelDropped();
+
+/* Create a console, to be drawn with DUI_ConsolePanel.
+ *
+ * The text of the most recent lines is kept in a ring buffer, and the 
+ *   oldest lines are discarded once either limit is reached.
+ * Nothing is allocated after creation.
+ *
+ * @param lines: The number of lines to keep, rounded up to a power of two.
+ *
+ * @param bytes: The total length of the lines to keep, rounded up to a 
+ *   power of two. Longer lines are truncated to this length.
+ *
+ * @return: The new console, or NULL if it could not be allocated.
+ */
+DUI_Console * DUI_CreateConsole(size_t lines, size_t bytes);
+
+/* Destroy a console created with DUI_CreateConsole.
+ */
+void DUI_DestroyConsole(DUI_Console * console);
+
+/* Append text to a console, as one line per newline-separated part.
+ *
+ * A single trailing newline ends the last line, so "x\n" appends one line.
+ *
+ * This only copies the text, and can be called any number of times per 
+ *   frame. It is not thread safe, see DUI_ChannelPush for that.
+ *
+ * @param console: The console to append to.
+ *
+ * @param text: The text to append.
+ */
+void DUI_ConsoleAppend(DUI_Console * console, const char * text);
+
+/* Append formatted text to a console.
+ *
+ * Behaves like DUI_ConsoleAppend.
+ *
+ * @param console: The console to append to.
+ *
+ * @param format: The format string to pass to vsnprintf.
+ */
+void DUI_ConsolePrint(DUI_Console * console, const char * format, ...);
+
+/* Discard every line in a console.
+ */
+void DUI_ConsoleClear(DUI_Console * console);
+
+/* Get the number of lines currently in a console.
+ *
+ * @param console: The console.
+ *
+ * @return: The number of lines.
+ */
+size_t DUI_ConsoleCount(const DUI_Console * console);
+
+/* Draw the lines of a console that fit in the given size, with a scroll bar.
+ *
+ * Only the visible lines are drawn, so the cost does not depend on how many 
+ *   lines the console holds. The mouse wheel or the scroll bar scroll back
+ *   through older lines. While scrolled to the bottom, the console follows
+ *   new lines as they are appended.
+ *
+ * Lines are truncated to the width of the panel.
+ *
+ * @param console: The console to draw.
+ *
+ * @param width: The width of the panel.
+ *
+ * @param height: The height of the panel.
+ */
+void DUI_ConsolePanel(DUI_Console * console, int width, int height);
+
+#endif // DUI_H
+
+#if defined(DUI_IMPLEMENTATION)
+
+#if defined(DUI_FONT_ANONYMOUS)
+#   include <DUI/DUI_FontAnonymous.h>
+#else
+#   include <DUI/DUI_FontGB.h>
+#endif
+
+#if defined(DUI_TRUETYPE)
+#   include <DUI/DUI_TrueType.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+#   define DUI_X86_64
+#   include <immintrin.h>
+
+// Functions using AVX2 are only called if SDL_HasAVX2()
+#   if defined(__GNUC__) || defined(__clang__)
+#       define DUI_TARGET_AVX2 __attribute__((target("avx2")))
+#   else
+#       define DUI_TARGET_AVX2
+#   endif
+#endif
+
+SDL_Window *   _duiWindow      = NULL;
+SDL_Renderer * _duiRenderer    = NULL;
+SDL_Texture *  _duiFontTexture = NULL;
+
+int _duiWindowID = 0;
+
+typedef struct
+{
+    bool Fixed;
+    SDL_Rect Bounds;
+    const char * Title;
+
+    // The layer the panel was started on
+    DUI_Layer Layer;
+
+    // Index of the first of the commands reserved by DUI_PanelStart, or -1
+    int Command;
+
+} DUI_PanelInfo;
+
+#ifndef DUI_PANEL_STACK_DEPTH
+#   define DUI_PANEL_STACK_DEPTH (10)
+#endif // DUI_PANEL_STACK_DEPTH
+
+DUI_PanelInfo _duiPanelStack[DUI_PANEL_STACK_DEPTH + 1];
+int _duiPanelStackIndex = 0;
+
+// Created on first use
+SDL_Texture * _duiOverlayTexture = NULL;
+
+// The default number of times per second the performance HUD is redrawn
+#ifndef DUI_PERF_HUD_RATE
+#   define DUI_PERF_HUD_RATE (4.0f)
+#endif // DUI_PERF_HUD_RATE
+
+// The number of frame times shown in the performance HUD's graph
+#ifndef DUI_PERF_HUD_SAMPLES
+#   define DUI_PERF_HUD_SAMPLES (120)
+#endif // DUI_PERF_HUD_SAMPLES
+
+#define DUI_PERF_HUD_COLUMNS (40)
+#define DUI_PERF_HUD_LINES (6)
+
+// The height of the frame time graph, in lines
+#define DUI_PERF_HUD_GRAPH_LINES (3)
+
+bool _duiPerfHUD = false;
+
+// The number of ticks between redraws of the HUD
+uint64_t _duiPerfHUDInterval = 0;
+uint64_t _duiPerfHUDUpdated = 0;
+
+// The time of the end of each recent DUI_Render, to calculate frame times
+uint64_t _duiPerfHUDFrames[DUI_PERF_HUD_SAMPLES];
+uint32_t _duiPerfHUDFrameCount = 0;
+
+// The stats for the previous frame, and the frame being recorded
+DUI_Stats _duiStats = { 0 };
+DUI_Stats _duiStatsFrame = { 0 };
+
+uint64_t _duiPrintTicks = 0;
+
+#ifndef DUI_TARGET_POOL_SIZE
+#   define DUI_TARGET_POOL_SIZE (16)
+#endif // DUI_TARGET_POOL_SIZE
+
+// The number of frames a pooled render target can go unused before it is destroyed
+#ifndef DUI_TARGET_POOL_TIMEOUT
+#   define DUI_TARGET_POOL_TIMEOUT (300)
+#endif // DUI_TARGET_POOL_TIMEOUT
+
+// Render target sizes are rounded up to a multiple of this, so that
+//   panels which change size slightly can keep using the same texture
+#define DUI_TARGET_GRANULARITY (64)
+
+// Extra space given to new render targets, as a percentage of the size
+//   requested, so that resizing a window doesn't create a texture every frame
+#ifndef DUI_TARGET_HEADROOM
+#   define DUI_TARGET_HEADROOM (25)
+#endif // DUI_TARGET_HEADROOM
+
+typedef struct
+{
+    SDL_Texture * Texture;
+    int Width;
+    int Height;
+
+    bool InUse;
+    uint32_t LastUsed;
+
+} DUI_PooledTarget;
+
+DUI_PooledTarget _duiTargetPool[DUI_TARGET_POOL_SIZE];
+
+// Incremented at the end of each DUI_Render
+uint32_t _duiFrame = 0;
+
+bool _duiRetained = false;
+
+// The texture retained between frames, and the size of the area that is valid
+SDL_Texture * _duiRetainedTexture = NULL;
+int _duiRetainedWidth = 0;
+int _duiRetainedHeight = 0;
+
+// The size of _duiRetainedTexture, which can be larger than the window
+int _duiRetainedTextureWidth = 0;
+int _duiRetainedTextureHeight = 0;
+
+// The hash of the frame drawn into _duiRetainedTexture
+uint64_t _duiRetainedHash = 0;
+
+DUI_CacheStats _duiRetainedStats = { 0 };
+
+#ifndef DUI_MAX_DIRTY_RECTS
+#   define DUI_MAX_DIRTY_RECTS (32)
+#endif // DUI_MAX_DIRTY_RECTS
+
+typedef struct
+{
+    uint64_t Hash;
+    SDL_Rect Bounds;
+
+    // The index of the next previous item with the same hash
+    size_t Next;
+
+} DUI_RetainedItem;
+
+typedef struct
+{
+    uint64_t Hash;
+    int Count;
+
+    // The index of the first previous item with this hash not yet matched
+    size_t First;
+
+} DUI_RetainedSlot;
+
+// The items drawn into _duiRetainedTexture, and the items of the current frame
+DUI_RetainedItem * _duiRetainedItems[2] = { NULL, NULL };
+size_t _duiRetainedItemCount[2] = { 0, 0 };
+size_t _duiRetainedItemCapacity[2] = { 0, 0 };
+
+// Open addressing table used to match the items of two frames
+DUI_RetainedSlot * _duiRetainedSlots = NULL;
+size_t _duiRetainedSlotCapacity = 0;
+
+SDL_Rect _duiDirtyRects[DUI_MAX_DIRTY_RECTS];
+int _duiDirtyRectCount = 0;
+int _duiMaxDirtyRects = DUI_MAX_DIRTY_RECTS;
+
+// False when the contents of _duiRetainedTexture cannot be reused
+bool _duiRetainedValid = false;
+
+typedef enum
+{
+    DUI_COMMAND_FILL_RECT,
+    DUI_COMMAND_DRAW_RECT,
+    DUI_COMMAND_TEXT,
+    DUI_COMMAND_PANEL_BEGIN,
+    DUI_COMMAND_PANEL_END,
+    DUI_COMMAND_LINES,
+
+} DUI_CommandType;
+
+typedef struct
+{
+    uint8_t Type;
+    uint8_t Layer;
+
+    union {
+        // DUI_COMMAND_TEXT: The width of each character, the height is Bounds.h
+        uint16_t CharWidth;
+
+        // DUI_COMMAND_PANEL_BEGIN: The DUI_PanelFlags the panel was started with
+        uint16_t PanelFlags;
+    };
+
+    uint8_t Color[4];
+
+    SDL_Rect Bounds;
+
+    // DUI_COMMAND_TEXT: The range of the text in DUI_DrawList.Text
+    // DUI_COMMAND_LINES: The range of the points in DUI_DrawList.Points
+    uint32_t Offset;
+    uint32_t Length;
+
+} DUI_DrawCommand;
+
+typedef struct
+{
+    DUI_DrawCommand * Commands;
+    size_t CommandCount;
+    size_t CommandCapacity;
+
+    char * Text;
+    size_t TextLength;
+    size_t TextCapacity;
+
+    SDL_Point * Points;
+    size_t PointCount;
+    size_t PointCapacity;
+
+    // Scratch space used by DUI_Render to sort Commands by layer
+    DUI_DrawCommand * Sorted;
+    size_t SortedCapacity;
+
+    // Bitmask of the layers recorded to this frame
+    uint32_t Layers;
+
+} DUI_DrawList;
+
+DUI_DrawList _duiDrawList = { 0 };
+
+uint8_t _duiDrawColor[4] = { 0xFF, 0xFF, 0xFF, 0xFF };
+
+// Text is drawn with the colors of the font itself
+const uint8_t DUI_TEXT_COLOR[4] = { 0xFF, 0xFF, 0xFF, 0xFF };
+
+DUI_Layer _duiLayer = DUI_LAYER_DEFAULT;
+
+// Lookup table from character to font glyph, built by DUI_Init
+DUI_Glyph _duiGlyphs[256];
+
+#define DUI_GLYPH_PAGE_SIZE (256)
+#define DUI_GLYPH_PAGE_COUNT (0x110000 / DUI_GLYPH_PAGE_SIZE)
+
+// Glyphs for every codepoint, in pages of 256 that are allocated by
+//   DUI_AddGlyph, page 0 is _duiGlyphs
+DUI_Glyph * _duiGlyphPages[DUI_GLYPH_PAGE_COUNT] = { _duiGlyphs };
+
+// Incremented whenever a glyph is replaced, to invalidate cached text
+uint32_t _duiGlyphGeneration = 0;
+
+// Textures created by DUI_AddGlyphPage
+SDL_Texture ** _duiGlyphTextures = NULL;
+size_t _duiGlyphTextureCount = 0;
+size_t _duiGlyphTextureCapacity = 0;
+
+typedef struct
+{
+    uint32_t Codepoint;
+    DUI_Glyph Glyph;
+
+} DUI_UserGlyph;
+
+// Glyphs added with DUI_AddGlyph, which are set again when the font changes
+DUI_UserGlyph * _duiUserGlyphs = NULL;
+size_t _duiUserGlyphCount = 0;
+size_t _duiUserGlyphCapacity = 0;
+
+// The index + 1 of each codepoint in _duiUserGlyphs, or 0 if it has none,
+//   in pages like _duiGlyphPages that are allocated by DUI_AddGlyph
+uint32_t * _duiUserGlyphPages[DUI_GLYPH_PAGE_COUNT] = { NULL };
+
+#define DUI_REPLACEMENT_CHARACTER (0xFFFD)
+
+bool DUI_setGlyph(uint32_t codepoint, const DUI_Glyph * glyph)
+{
+    DUI_Glyph ** page = &_duiGlyphPages[codepoint / DUI_GLYPH_PAGE_SIZE];
+
+    if (!*page) {
+        *page = SDL_malloc(DUI_GLYPH_PAGE_SIZE * sizeof(DUI_Glyph));
+        if (!*page) {
+            return false;
+        }
+
+        for (int i = 0; i < DUI_GLYPH_PAGE_SIZE; ++i) {
+            (*page)[i] = _duiGlyphs['?'];
+        }
+    }
+
+    (*page)[codepoint % DUI_GLYPH_PAGE_SIZE] = *glyph;
+
+    // Lines already drawn with the previous glyph must be drawn again
+    ++_duiGlyphGeneration;
+
+    return true;
+}
+
+// Free every page added by DUI_setGlyph
+void DUI_freeGlyphPages()
+{
+    for (int i = 1; i < DUI_GLYPH_PAGE_COUNT; ++i) {
+        SDL_free(_duiGlyphPages[i]);
+        _duiGlyphPages[i] = NULL;
+    }
+
+    ++_duiGlyphGeneration;
+}
+
+// Set the glyphs added with DUI_AddGlyph again, over those of the font
+void DUI_applyUserGlyphs()
+{
+    for (size_t i = 0; i < _duiUserGlyphCount; ++i) {
+        DUI_setGlyph(_duiUserGlyphs[i].Codepoint, &_duiUserGlyphs[i].Glyph);
+    }
+}
+
+bool DUI_isContinuationByte(unsigned char c)
+{
+    return ((c & 0xC0) == 0x80);
+}
+
+// Decode the character that starts at text[*index], and move *index past it.
+//   An ASCII byte is always one character, as DUI_drawGlyphs draws it. Any 
+//   other byte starts a character with every continuation byte after it, so 
+//   invalid sequences decode to one U+FFFD each, as DUI_countCharacters expects
+uint32_t DUI_decodeUTF8(const unsigned char * text, size_t length, size_t * index)
+{
+    size_t i = *index;
+    unsigned char c = text[i++];
+
+    if (c < 0x80) {
+        *index = i;
+        return c;
+    }
+
+    size_t end = i;
+    while (end < length && DUI_isContinuationByte(text[end])) {
+        ++end;
+    }
+
+    *index = end;
+
+    int expected;
+    uint32_t codepoint;
+    uint32_t minimum;
+
+    if ((c & 0xE0) == 0xC0) {
+        expected = 1;
+        codepoint = (c & 0x1F);
+        minimum = 0x80;
+    }
+    else if ((c & 0xF0) == 0xE0) {
+        expected = 2;
+        codepoint = (c & 0x0F);
+        minimum = 0x800;
+    }
+    else if ((c & 0xF8) == 0xF0) {
+        expected = 3;
+        codepoint = (c & 0x07);
+        minimum = 0x10000;
+    }
+    else {
+        return DUI_REPLACEMENT_CHARACTER;
+    }
+
+    if (end - i != (size_t)expected) {
+        return DUI_REPLACEMENT_CHARACTER;
+    }
+
+    for (; i < end; ++i) {
+        codepoint = (codepoint << 6) | (text[i] & 0x3F);
+    }
+
+    // Overlong encodings, surrogates, and values past the end of Unicode
+    if (codepoint < minimum 
+        || (codepoint >= 0xD800 && codepoint <= 0xDFFF) 
+        || codepoint > 0x10FFFF) {
+        return DUI_REPLACEMENT_CHARACTER;
+    }
+
+    return codepoint;
+}
+
+// Check if a character starts at text[index], which is where DUI_decodeUTF8
+//   stops. Continuation bytes only continue a character with a non-ASCII lead
+bool DUI_startsCharacter(const unsigned char * text, size_t index)
+{
+    return (!DUI_isContinuationByte(text[index]) 
+        || index == 0 || text[index - 1] < 0x80);
+}
+
+// Count the characters DUI_decodeUTF8 would decode from the text
+size_t DUI_countCharacters(const char * text, size_t length)
+{
+    const unsigned char * bytes = (const unsigned char *)text;
+    size_t count = 0;
+    size_t i = 0;
+
+    // Skip through ASCII 8 bytes at a time
+    while (i + sizeof(uint64_t) <= length) {
+        uint64_t word;
+        SDL_memcpy(&word, bytes + i, sizeof(word));
+
+        if ((word & 0x8080808080808080ull) == 0) {
+            count += sizeof(uint64_t);
+        }
+        else {
+            for (size_t j = 0; j < sizeof(uint64_t); ++j) {
+                count += DUI_startsCharacter(bytes, i + j);
+            }
+        }
+
+        i += sizeof(uint64_t);
+    }
+
+    for (; i < length; ++i) {
+        count += DUI_startsCharacter(bytes, i);
+    }
+
+    return count;
+}
+
+// Get the length in bytes of the first count characters of the text
+size_t DUI_characterPrefix(const char * text, size_t length, size_t count)
+{
+    const unsigned char * bytes = (const unsigned char *)text;
+
+    size_t i = 0;
+    for (size_t n = 0; n < count && i < length; ++n) {
+        DUI_decodeUTF8(bytes, length, &i);
+    }
+
+    return i;
+}
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+#   define DUI_RENDER_GEOMETRY
+#endif
+
+typedef struct
+{
+    SDL_Texture * Texture;
+    float TextureWidth;
+    float TextureHeight;
+
+    SDL_Vertex * Vertices;
+    size_t VertexCount;
+    size_t VertexCapacity;
+
+    int * Indices;
+    size_t IndexCount;
+    size_t IndexCapacity;
+
+} DUI_GlyphBatch;
+
+// Glyph quads waiting to be submitted with SDL_RenderGeometry
+DUI_GlyphBatch _duiGlyphBatch = { 0 };
+
+#ifndef DUI_TEXT_CACHE_PAGE_SIZE
+#   define DUI_TEXT_CACHE_PAGE_SIZE (1024)
+#endif // DUI_TEXT_CACHE_PAGE_SIZE
+
+#ifndef DUI_TEXT_CACHE_MAX_PAGES
+#   define DUI_TEXT_CACHE_MAX_PAGES (16)
+#endif // DUI_TEXT_CACHE_MAX_PAGES
+
+// Must be a power of two
+#ifndef DUI_TEXT_CACHE_ENTRIES
+#   define DUI_TEXT_CACHE_ENTRIES (4096)
+#endif // DUI_TEXT_CACHE_ENTRIES
+
+// Shorter lines are cheaper to draw character by character
+#ifndef DUI_TEXT_CACHE_MIN_LENGTH
+#   define DUI_TEXT_CACHE_MIN_LENGTH (4)
+#endif // DUI_TEXT_CACHE_MIN_LENGTH
+
+// The number of entries a line of text can be stored in
+#define DUI_TEXT_CACHE_WAYS (4)
+
+#define DUI_TEXT_CACHE_PAGE_BYTES \
+    ((size_t)DUI_TEXT_CACHE_PAGE_SIZE * DUI_TEXT_CACHE_PAGE_SIZE * 4)
+
+typedef struct
+{
+    // Hash of the text and its size, 0 if the entry is empty
+    uint64_t Key;
+
+    // The page the text was drawn into, or -1 if it hasn't been yet
+    int Page;
+    SDL_Rect Src;
+
+    uint32_t FirstSeen;
+    uint32_t LastUsed;
+
+} DUI_TextCacheEntry;
+
+typedef struct
+{
+    SDL_Texture * Texture;
+
+    // The next free space, filled left to right, in rows (shelves)
+    int ShelfX;
+    int ShelfY;
+    int ShelfHeight;
+
+    uint32_t LastUsed;
+
+} DUI_TextCachePage;
+
+DUI_TextCacheEntry _duiTextCache[DUI_TEXT_CACHE_ENTRIES];
+DUI_TextCachePage _duiTextCachePages[DUI_TEXT_CACHE_MAX_PAGES];
+
+size_t _duiTextCacheBudget = DUI_TEXT_CACHE_PAGE_BYTES;
+
+DUI_CacheStats _duiTextCacheStats = { 0 };
+
+// The cache entry for each command being replayed this frame, or -1
+int * _duiTextCacheLookups = NULL;
+size_t _duiTextCacheLookupCapacity = 0;
+
+// The frame and commands that _duiTextCacheLookups was filled for
+uint32_t _duiTextCacheFrame = UINT32_MAX;
+const DUI_DrawCommand * _duiTextCacheCommands = NULL;
+size_t _duiTextCacheCount = 0;
+
+DUI_Style _duiStyle = {
+    .CharWidth = DUI_FONT_CHAR_WIDTH,
+    .CharHeight = DUI_FONT_CHAR_HEIGHT,
+
+    .LinePadding = 4,
+
+    .PanelPadding = 8,
+
+    .ButtonPadding = 4,
+    .ButtonMargin  = 8,
+
+    .TabPadding = 8,
+    .TabMargin  = 8,
+
+    .ColorBackground = { 0xEE, 0xEE, 0xEE, 0xFF },
+    .ColorBorder     = { 0x00, 0x00, 0x00, 0xFF },
+    .ColorHover      = { 0xEE, 0xEE, 0xEE, 0xEE },
     .ColorDefault    = { 0xAA, 0xAA, 0xAA, 0xAA },
 };
 
-int _duiLineStart = 0;
+int _duiLineStart = 0;
+
+SDL_Point _duiMouse     = { 0, 0 };
+SDL_Point _duiCursor    = { 0, 0 };
+SDL_Point _duiTabCursor = { 0, 0 };
+
+int _duiWindowWidth;
+int _duiWindowHeight;
+
+// Set by DUI_eventWatch, which can be called from any thread, and
+//   applied in DUI_Update. The new width and height are packed in with
+//   DUI_RESIZE_PENDING, so they are always read together
+#define DUI_RESIZE_PENDING (0x80000000u)
+
+SDL_atomic_t _duiResizePending = { 0 };
+
+bool _duiMouseDown = false;
+bool _duiClicked = false;
+
+// Set by DUI_eventWatch, and applied in DUI_Update
+SDL_atomic_t _duiWheelPending = { 0 };
+
+// The distance the mouse wheel was scrolled this frame, positive is away
+//   from the user, cleared by the first widget to use it
+int _duiWheel = 0;
+
+DUI_PanelInfo * DUI_getCurrentPanel()
+{
+    return &_duiPanelStack[_duiPanelStackIndex];
+}
+
+void DUI_popPanel()
+{
+    --_duiPanelStackIndex;
+}
+
+DUI_PanelInfo * DUI_pushPanel()
+{
+    ++_duiPanelStackIndex;
+    DUI_PanelInfo * panel = DUI_getCurrentPanel();
+    panel->Bounds = (SDL_Rect){ 0, 0, 0, 0 };
+    return panel;
+}
+
+void DUI_growPanel()
+{
+    DUI_PanelInfo * panel = DUI_getCurrentPanel();
+    if (panel->Fixed) {
+        return;
+    }
+
+    int x = (_duiCursor.x - panel->Bounds.x);
+    int y = (_duiCursor.y - panel->Bounds.y);
+
+    if (x > panel->Bounds.w) {
+        panel->Bounds.w = x;
+    }
+
+    if (y > panel->Bounds.h) {
+        panel->Bounds.h = y;
+    }
+}
+
+bool DUI_reserve(void ** data, size_t * capacity, size_t count, size_t size)
+{
+    if (count <= *capacity) {
+        return true;
+    }
+
+    size_t newCapacity = (*capacity > 0 ? *capacity * 2 : 256);
+    while (newCapacity < count) {
+        newCapacity *= 2;
+    }
+
+    void * newData = SDL_realloc(*data, newCapacity * size);
+    if (!newData) {
+        return false;
+    }
+
+    *data = newData;
+    *capacity = newCapacity;
+    return true;
+}
+
+void DUI_setDrawColor(const uint8_t color[4])
+{
+    SDL_memcpy(_duiDrawColor, color, sizeof(_duiDrawColor));
+}
+
+DUI_DrawCommand * DUI_pushCommand(DUI_CommandType type, const SDL_Rect * bounds)
+{
+    DUI_DrawList * list = &_duiDrawList;
+
+    if (!DUI_reserve((void **)&list->Commands, &list->CommandCapacity,
+            list->CommandCount + 1, sizeof(DUI_DrawCommand))) {
+        return NULL;
+    }
+
+    DUI_DrawCommand * command = &list->Commands[list->CommandCount];
+    ++list->CommandCount;
+
+    *command = (DUI_DrawCommand){
+        .Type = type,
+        .Layer = _duiLayer,
+        .Bounds = *bounds,
+    };
+
+    SDL_memcpy(command->Color, _duiDrawColor, sizeof(command->Color));
+
+    list->Layers |= (1u << _duiLayer);
+
+    return command;
+}
+
+void DUI_fillRect(const SDL_Rect * bounds)
+{
+    DUI_pushCommand(DUI_COMMAND_FILL_RECT, bounds);
+}
+
+void DUI_drawRect(const SDL_Rect * bounds)
+{
+    DUI_pushCommand(DUI_COMMAND_DRAW_RECT, bounds);
+}
+
+// Add a command to draw a line of text at the cursor, and return its width
+int DUI_pushText(const char * text, size_t length)
+{
+    DUI_DrawList * list = &_duiDrawList;
+
+    if (length == 0) {
+        return 0;
+    }
+
+    SDL_Rect bounds = {
+        .x = _duiCursor.x,
+        .y = _duiCursor.y,
+        .w = (int)DUI_countCharacters(text, length) * _duiStyle.CharWidth,
+        .h = _duiStyle.CharHeight,
+    };
+
+    if (!DUI_reserve((void **)&list->Text, &list->TextCapacity,
+            list->TextLength + length, sizeof(char))) {
+        return bounds.w;
+    }
+
+    // Continue the previous command if this text picks up where it left off,
+    //   such as DUI_Print("COUNT: "); DUI_Print("%d", count);
+    if (list->CommandCount > 0) {
+        DUI_DrawCommand * last = &list->Commands[list->CommandCount - 1];
+
+        if (last->Type == DUI_COMMAND_TEXT
+            && last->Layer == _duiLayer
+            && last->CharWidth == _duiStyle.CharWidth
+            && last->Bounds.h == bounds.h
+            && last->Bounds.y == bounds.y
+            && last->Bounds.x + last->Bounds.w == bounds.x
+            && last->Offset + last->Length == list->TextLength) {
+            SDL_memcpy(list->Text + list->TextLength, text, length);
+            list->TextLength += length;
+
+            last->Length += length;
+            last->Bounds.w += bounds.w;
+            return bounds.w;
+        }
+    }
+
+    DUI_DrawCommand * command = DUI_pushCommand(DUI_COMMAND_TEXT, &bounds);
+    if (!command) {
+        return bounds.w;
+    }
+
+    command->CharWidth = _duiStyle.CharWidth;
+    command->Offset = list->TextLength;
+    command->Length = length;
+    SDL_memcpy(command->Color, DUI_TEXT_COLOR, sizeof(command->Color));
+
+    SDL_memcpy(list->Text + list->TextLength, text, length);
+    list->TextLength += length;
+    return bounds.w;
+}
+
+// Reserve space for a line through count points, or return NULL
+SDL_Point * DUI_pushLines(const SDL_Rect * bounds, size_t count)
+{
+    DUI_DrawList * list = &_duiDrawList;
+
+    if (count < 2) {
+        return NULL;
+    }
+
+    if (!DUI_reserve((void **)&list->Points, &list->PointCapacity, 
+            list->PointCount + count, sizeof(SDL_Point))) {
+        return NULL;
+    }
+
+    DUI_DrawCommand * command = DUI_pushCommand(DUI_COMMAND_LINES, bounds);
+    if (!command) {
+        return NULL;
+    }
+
+    command->Offset = list->PointCount;
+    command->Length = count;
+
+    SDL_Point * points = list->Points + list->PointCount;
+    list->PointCount += count;
+    return points;
+}
+
+void DUI_printText(const char * text, size_t length)
+{
+    size_t lineStart = 0;
+
+    for (size_t i = 0; i <= length; ++i) {
+        if (i < length && text[i] != '\n') {
+            continue;
+        }
+
+        size_t lineLength = i - lineStart;
+        _duiCursor.x += DUI_pushText(text + lineStart, lineLength);
+
+        if (i < length) {
+            DUI_Newline();
+        }
+
+        lineStart = i + 1;
+    }
+
+    DUI_growPanel();
+}
+
+typedef struct
+{
+    SDL_Texture * Target;
+    uint8_t Color[4];
+    SDL_BlendMode BlendMode;
+
+    bool HasClip;
+    SDL_Rect Clip;
+
+} DUI_RenderState;
+
+// The state of _duiRenderer, as last set by DUI, valid during DUI_Render
+DUI_RenderState _duiRenderState;
+
+DUI_CacheStats _duiRenderStateStats = { 0 };
+
+// Read the current state, as the application can change it between frames
+void DUI_syncRenderState()
+{
+    DUI_RenderState * state = &_duiRenderState;
+
+    state->Target = SDL_GetRenderTarget(_duiRenderer);
+    SDL_GetRenderDrawColor(_duiRenderer, 
+        &state->Color[0], &state->Color[1], &state->Color[2], &state->Color[3]);
+    SDL_GetRenderDrawBlendMode(_duiRenderer, &state->BlendMode);
+
+    state->HasClip = SDL_RenderIsClipEnabled(_duiRenderer);
+    SDL_RenderGetClipRect(_duiRenderer, &state->Clip);
+}
+
+void DUI_setRenderTarget(SDL_Texture * texture)
+{
+    DUI_RenderState * state = &_duiRenderState;
+
+    if (state->Target == texture) {
+        ++_duiRenderStateStats.Hits;
+        return;
+    }
+
+    ++_duiRenderStateStats.Misses;
+    ++_duiStatsFrame.TargetSwitches;
+    state->Target = texture;
+    SDL_SetRenderTarget(_duiRenderer, texture);
+
+    // Each render target has its own clip rect
+    state->HasClip = SDL_RenderIsClipEnabled(_duiRenderer);
+    SDL_RenderGetClipRect(_duiRenderer, &state->Clip);
+}
+
+void DUI_setRenderDrawColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+{
+    DUI_RenderState * state = &_duiRenderState;
+
+    if (state->Color[0] == r && state->Color[1] == g 
+        && state->Color[2] == b && state->Color[3] == a) {
+        ++_duiRenderStateStats.Hits;
+        return;
+    }
+
+    ++_duiRenderStateStats.Misses;
+    state->Color[0] = r;
+    state->Color[1] = g;
+    state->Color[2] = b;
+    state->Color[3] = a;
+    SDL_SetRenderDrawColor(_duiRenderer, r, g, b, a);
+}
+
+void DUI_setRenderDrawBlendMode(SDL_BlendMode mode)
+{
+    DUI_RenderState * state = &_duiRenderState;
+
+    if (state->BlendMode == mode) {
+        ++_duiRenderStateStats.Hits;
+        return;
+    }
+
+    ++_duiRenderStateStats.Misses;
+    state->BlendMode = mode;
+    SDL_SetRenderDrawBlendMode(_duiRenderer, mode);
+}
+
+void DUI_setRenderClip(const SDL_Rect * clip)
+{
+    DUI_RenderState * state = &_duiRenderState;
+
+    if (clip ? (state->HasClip && SDL_RectEquals(&state->Clip, clip)) : !state->HasClip) {
+        ++_duiRenderStateStats.Hits;
+        return;
+    }
+
+    ++_duiRenderStateStats.Misses;
+    state->HasClip = (clip != NULL);
+    if (clip) {
+        state->Clip = *clip;
+    }
+    SDL_RenderSetClipRect(_duiRenderer, clip);
+}
+
+#ifndef DUI_RECT_BATCH_SIZE
+#   define DUI_RECT_BATCH_SIZE (256)
+#endif // DUI_RECT_BATCH_SIZE
+
+// The number of colors that can be batched at once
+#define DUI_RECT_BATCH_BUCKETS (8)
+
+typedef struct
+{
+    SDL_Rect Rect;
+    int Bucket;
+
+    // Only the edges are drawn, anything inside doesn't overlap it
+    bool Outline;
+
+} DUI_BatchedRect;
+
+typedef struct
+{
+    bool Outline;
+    uint8_t Color[4];
+
+} DUI_RectBucket;
+
+typedef struct
+{
+    DUI_BatchedRect Rects[DUI_RECT_BATCH_SIZE];
+    int RectCount;
+
+    // Drawn in order, each with one call to SDL_RenderFillRects or SDL_RenderDrawRects
+    DUI_RectBucket Buckets[DUI_RECT_BATCH_BUCKETS];
+    int BucketCount;
+
+    // The bounds of the text in _duiGlyphBatch, which is drawn after the rects
+    SDL_Rect Text[DUI_RECT_BATCH_SIZE];
+    int TextCount;
+
+    SDL_Rect Scratch[DUI_RECT_BATCH_SIZE];
+
+} DUI_RectBatch;
+
+// Rects waiting to be submitted, grouped by color
+DUI_RectBatch _duiRectBatch;
+
+// Check if a is entirely inside the edges of b
+bool DUI_rectInside(const SDL_Rect * a, const SDL_Rect * b)
+{
+    return (a->x > b->x && a->x + a->w < b->x + b->w 
+        && a->y > b->y && a->y + a->h < b->y + b->h);
+}
+
+bool DUI_batchedRectsOverlap(const DUI_BatchedRect * a, const DUI_BatchedRect * b)
+{
+    if (!SDL_HasIntersection(&a->Rect, &b->Rect)) {
+        return false;
+    }
+
+    if (a->Outline && DUI_rectInside(&b->Rect, &a->Rect)) {
+        return false;
+    }
+
+    if (b->Outline && DUI_rectInside(&a->Rect, &b->Rect)) {
+        return false;
+    }
+
+    return true;
+}
+
+void DUI_flushRects()
+{
+    DUI_RectBatch * batch = &_duiRectBatch;
+
+    for (int i = 0; i < batch->BucketCount; ++i) {
+        DUI_RectBucket * bucket = &batch->Buckets[i];
+
+        int count = 0;
+        for (int j = 0; j < batch->RectCount; ++j) {
+            if (batch->Rects[j].Bucket == i) {
+                batch->Scratch[count++] = batch->Rects[j].Rect;
+            }
+        }
+
+        DUI_setRenderDrawColor(
+            bucket->Color[0],
+            bucket->Color[1],
+            bucket->Color[2],
+            bucket->Color[3]);
+
+        if (bucket->Outline) {
+            ++_duiStatsFrame.OutlineCalls;
+            SDL_RenderDrawRects(_duiRenderer, batch->Scratch, count);
+        }
+        else {
+            ++_duiStatsFrame.FillCalls;
+            SDL_RenderFillRects(_duiRenderer, batch->Scratch, count);
+        }
+    }
+
+    batch->RectCount = 0;
+    batch->BucketCount = 0;
+}
+
+void DUI_flushGlyphs()
+{
+    // Text is always drawn over the rects batched before it
+    DUI_flushRects();
+    _duiRectBatch.TextCount = 0;
+
+#if defined(DUI_RENDER_GEOMETRY)
+    DUI_GlyphBatch * batch = &_duiGlyphBatch;
+
+    if (batch->IndexCount == 0) {
+        return;
+    }
+
+    ++_duiStatsFrame.GeometryCalls;
+    SDL_RenderGeometry(_duiRenderer, batch->Texture,
+        batch->Vertices, batch->VertexCount,
+        batch->Indices, batch->IndexCount);
+
+    batch->VertexCount = 0;
+    batch->IndexCount = 0;
+#endif
+}
+
+void DUI_pushTextBounds(const SDL_Rect * bounds)
+{
+    DUI_RectBatch * batch = &_duiRectBatch;
+
+    if (batch->TextCount == DUI_RECT_BATCH_SIZE) {
+        DUI_flushGlyphs();
+    }
+
+    batch->Text[batch->TextCount++] = *bounds;
+}
+
+void DUI_pushGlyph(SDL_Texture * texture, const SDL_Rect * src, const SDL_Rect * dst, 
+    const uint8_t color[4])
+{
+    ++_duiStatsFrame.Glyphs;
+
+#if defined(DUI_RENDER_GEOMETRY)
+    DUI_GlyphBatch * batch = &_duiGlyphBatch;
+
+    if (texture != batch->Texture) {
+        // Nothing needs to be drawn yet if there are no glyphs waiting
+        if (batch->IndexCount > 0) {
+            DUI_RectBatch * rects = &_duiRectBatch;
+
+            // The rest of the text being drawn is still batched, so rects
+            //   after it must be checked against its bounds
+            SDL_Rect current = { 0 };
+            bool drawingText = (rects->TextCount > 0);
+            if (drawingText) {
+                current = rects->Text[rects->TextCount - 1];
+            }
+
+            DUI_flushGlyphs();
+
+            if (drawingText) {
+                DUI_pushTextBounds(&current);
+            }
+        }
+
+        int width, height;
+        SDL_QueryTexture(texture, NULL, NULL, &width, &height);
+
+        batch->Texture = texture;
+        batch->TextureWidth = width;
+        batch->TextureHeight = height;
+    }
+
+    if (!DUI_reserve((void **)&batch->Vertices, &batch->VertexCapacity, 
+            batch->VertexCount + 4, sizeof(SDL_Vertex))) {
+        return;
+    }
+
+    if (!DUI_reserve((void **)&batch->Indices, &batch->IndexCapacity, 
+            batch->IndexCount + 6, sizeof(int))) {
+        return;
+    }
+
+    float x0 = dst->x;
+    float y0 = dst->y;
+    float x1 = dst->x + dst->w;
+    float y1 = dst->y + dst->h;
+
+    float u0 = src->x / batch->TextureWidth;
+    float v0 = src->y / batch->TextureHeight;
+    float u1 = (src->x + src->w) / batch->TextureWidth;
+    float v1 = (src->y + src->h) / batch->TextureHeight;
+
+    SDL_Color vertexColor = { color[0], color[1], color[2], color[3] };
+
+    int first = batch->VertexCount;
+
+    SDL_Vertex * vertices = &batch->Vertices[batch->VertexCount];
+    vertices[0] = (SDL_Vertex){ { x0, y0 }, vertexColor, { u0, v0 } };
+    vertices[1] = (SDL_Vertex){ { x1, y0 }, vertexColor, { u1, v0 } };
+    vertices[2] = (SDL_Vertex){ { x1, y1 }, vertexColor, { u1, v1 } };
+    vertices[3] = (SDL_Vertex){ { x0, y1 }, vertexColor, { u0, v1 } };
+    batch->VertexCount += 4;
+
+    int * indices = &batch->Indices[batch->IndexCount];
+    indices[0] = first;
+    indices[1] = first + 1;
+    indices[2] = first + 2;
+    indices[3] = first;
+    indices[4] = first + 2;
+    indices[5] = first + 3;
+    batch->IndexCount += 6;
+#else
+    DUI_flushRects();
+    ++_duiStatsFrame.CopyCalls;
+    SDL_RenderCopy(_duiRenderer, texture, src, dst);
+#endif
+}
+
+void DUI_pushRect(const SDL_Rect * rect, const uint8_t color[4], bool outline)
+{
+    DUI_RectBatch * batch = &_duiRectBatch;
+    DUI_BatchedRect item = { .Rect = *rect, .Outline = outline };
+
+    // The batched text will be drawn after this, so it can't overlap it
+    for (int i = 0; i < batch->TextCount; ++i) {
+        DUI_BatchedRect text = { .Rect = batch->Text[i], .Outline = false };
+
+        if (DUI_batchedRectsOverlap(&item, &text)) {
+            DUI_flushGlyphs();
+            break;
+        }
+    }
+
+    if (batch->RectCount == DUI_RECT_BATCH_SIZE) {
+        DUI_flushRects();
+    }
+
+    // It has to be drawn after every bucket with a rect it overlaps
+    int first = 0;
+    for (int i = 0; i < batch->RectCount; ++i) {
+        if (batch->Rects[i].Bucket >= first 
+            && DUI_batchedRectsOverlap(&item, &batch->Rects[i])) {
+            first = batch->Rects[i].Bucket + 1;
+        }
+    }
+
+    int bucket = first;
+    for (; bucket < batch->BucketCount; ++bucket) {
+        DUI_RectBucket * other = &batch->Buckets[bucket];
+
+        if (other->Outline == outline && SDL_memcmp(other->Color, color, 4) == 0) {
+            break;
+        }
+    }
+
+    if (bucket == batch->BucketCount) {
+        if (batch->BucketCount == DUI_RECT_BATCH_BUCKETS) {
+            DUI_flushRects();
+            bucket = 0;
+        }
+
+        batch->Buckets[bucket].Outline = outline;
+        SDL_memcpy(batch->Buckets[bucket].Color, color, 4);
+        batch->BucketCount = bucket + 1;
+    }
+
+    item.Bucket = bucket;
+    batch->Rects[batch->RectCount++] = item;
+}
+
+void DUI_buildGlyphTable()
+{
+    int charPerLine = (DUI_FONT_MAP_WIDTH / DUI_FONT_CHAR_WIDTH);
+
+    const char * questionMark = strchr(DUI_FONT_MAP, '?');
+
+    for (int c = 0; c < 256; ++c) {
+        DUI_Glyph * glyph = &_duiGlyphs[c];
+
+        if (c == ' ') {
+            *glyph = (DUI_Glyph){ .Texture = NULL };
+            continue;
+        }
+
+        char search = c;
+        if (DUI_FONT_UPPERCASE) {
+            search = toupper(c);
+        }
+
+        const char * index = NULL;
+        if (search != '\0') {
+            index = strchr(DUI_FONT_MAP, search);
+        }
+
+        if (index == NULL) {
+            index = questionMark;
+        }
+
+        size_t offset = index - DUI_FONT_MAP;
+
+        glyph->Texture = _duiFontTexture;
+        glyph->Src = (SDL_Rect){
+            .x = (offset % charPerLine) * DUI_FONT_CHAR_WIDTH,
+            .y = (offset / charPerLine) * DUI_FONT_CHAR_HEIGHT,
+            .w = DUI_FONT_CHAR_WIDTH,
+            .h = DUI_FONT_CHAR_HEIGHT,
+        };
+    }
+}
+
+#if defined(DUI_TRUETYPE)
+
+// The width and height of each font atlas texture
+#ifndef DUI_FONT_ATLAS_SIZE
+#   define DUI_FONT_ATLAS_SIZE (512)
+#endif // DUI_FONT_ATLAS_SIZE
+
+#ifndef DUI_FONT_MAX_PAGES
+#   define DUI_FONT_MAX_PAGES (8)
+#endif // DUI_FONT_MAX_PAGES
+
+#define DUI_FONT_MAX_SHELVES (128)
+
+// The height of a line of text in the distance field atlas
+#ifndef DUI_FONT_SDF_SIZE
+#   define DUI_FONT_SDF_SIZE (32)
+#endif // DUI_FONT_SDF_SIZE
+
+// How far from the outline distances are kept, in pixels of the atlas
+#ifndef DUI_FONT_SDF_SPREAD
+#   define DUI_FONT_SDF_SPREAD (4)
+#endif // DUI_FONT_SDF_SPREAD
+
+#ifndef DUI_FONT_SDF_MAX_THREADS
+#   define DUI_FONT_SDF_MAX_THREADS (16)
+#endif // DUI_FONT_SDF_MAX_THREADS
+
+// The number of text heights distance field pages are kept converted for,
+//   must be at least 2
+#ifndef DUI_FONT_MAX_RAMPS
+#   define DUI_FONT_MAX_RAMPS (4)
+#endif // DUI_FONT_MAX_RAMPS
+
+#define DUI_FONT_CACHE_VERSION (3)
+
+// The cache file holds the structs below as they are in memory, so it is
+//   only read by builds with the same byte order and struct layout
+#define DUI_FONT_CACHE_BYTE_ORDER (0x01020304u)
+
+typedef struct
+{
+    int32_t Y;
+    int32_t Height;
+
+    // The left of the unused space
+    int32_t X;
+
+} DUI_FontShelf;
+
+typedef struct
+{
+    // The page converted with each of DUI_Font.Ramps, or NULL until it is
+    //   drawn with that ramp. Glyphs refer to the first texture
+    SDL_Texture * Textures[DUI_FONT_MAX_RAMPS];
+
+    // The coverage or distance of each pixel, kept to write the cache file
+    uint8_t * Pixels;
+
+    // Glyphs are packed left to right into rows, called shelves, which 
+    //   are stacked from the top of the page
+    DUI_FontShelf Shelves[DUI_FONT_MAX_SHELVES];
+    int32_t ShelfCount;
+    int32_t Bottom;
+
+} DUI_FontPage;
+
+#define DUI_FONT_GLYPH_EMPTY (-1)
+#define DUI_FONT_GLYPH_MISSING (-2)
+
+// A rasterized glyph, as stored in the cache file
+typedef struct
+{
+    uint32_t Codepoint;
+
+    // The index of the page containing the glyph, or one of DUI_FONT_GLYPH_*
+    int32_t Page;
+
+    SDL_Rect Src;
+    float Left;
+    float Top;
+    float Width;
+    float Height;
+
+} DUI_FontGlyph;
+
+typedef struct
+{
+    char Magic[4];
+    uint32_t Version;
+
+    // DUI_FONT_CACHE_BYTE_ORDER, and DUI_getFontCacheLayout() of the build
+    //   that wrote the file, which come before anything that can be padded
+    uint32_t ByteOrder;
+    uint32_t Layout;
+
+    uint64_t FontHash;
+    int32_t PixelHeight;
+    int32_t Spread;
+    int32_t AtlasSize;
+    int32_t PageCount;
+    int32_t GlyphCount;
+
+} DUI_FontCacheHeader;
+
+// The alpha of each value in the atlas, for text drawn Height pixels tall
+typedef struct
+{
+    int Height;
+    uint8_t Alpha[256];
+
+    // The value of _duiFrame when the ramp was last drawn with
+    uint32_t LastUsed;
+
+} DUI_FontRamp;
+
+typedef struct
+{
+    void * Data;
+    DUI_TTFont TT;
+    uint64_t Hash;
+
+    int PixelHeight;
+    int CellWidth;
+    int Baseline;
+    float Scale;
+
+    // The spread of the distance field, or 0 if the atlas is coverage
+    int Spread;
+
+    // The first ramp is for the height the font was loaded at, the others
+    //   are built as CharHeight changes, replacing the least recently used
+    DUI_FontRamp Ramps[DUI_FONT_MAX_RAMPS];
+    int RampCount;
+
+    // The index of the ramp text is drawn with
+    int Ramp;
+
+    // One bit per codepoint, set once it has been rasterized
+    uint32_t * Baked;
+
+    DUI_FontPage Pages[DUI_FONT_MAX_PAGES];
+    int PageCount;
+
+    // Every glyph rasterized or loaded, to write the cache file
+    DUI_FontGlyph * Glyphs;
+    size_t GlyphCount;
+    size_t GlyphCapacity;
+
+    char * CachePath;
+
+    // True if glyphs were rasterized since the cache file was read
+    bool Dirty;
+
+} DUI_Font;
+
+DUI_Font _duiFont = { 0 };
+
+bool DUI_isFontGlyphBaked(uint32_t codepoint)
+{
+    return (_duiFont.Baked[codepoint / 32] & (1u << (codepoint % 32))) != 0;
+}
+
+// Copy an area of a page's coverage to one of its textures, as white with
+//   alpha from the ramp
+void DUI_uploadFontTexture(DUI_FontPage * page, int ramp, const SDL_Rect * rect)
+{
+    uint8_t * pixels = SDL_malloc(rect->w * rect->h * 4);
+    if (!pixels) {
+        return;
+    }
+
+    const uint8_t * alpha = _duiFont.Ramps[ramp].Alpha;
+
+    for (int y = 0; y < rect->h; ++y) {
+        const uint8_t * src = page->Pixels + ((rect->y + y) * DUI_FONT_ATLAS_SIZE) + rect->x;
+        uint8_t * dst = pixels + (y * rect->w * 4);
+
+        for (int x = 0; x < rect->w; ++x) {
+            dst[(x * 4) + 0] = 0xFF;
+            dst[(x * 4) + 1] = 0xFF;
+            dst[(x * 4) + 2] = 0xFF;
+            dst[(x * 4) + 3] = alpha[src[x]];
+        }
+    }
+
+    SDL_UpdateTexture(page->Textures[ramp], rect, pixels, rect->w * 4);
+    SDL_free(pixels);
+}
+
+// Copy an area of a page's coverage to each of its textures
+void DUI_uploadFontPage(DUI_FontPage * page, const SDL_Rect * rect)
+{
+    for (int i = 0; i < _duiFont.RampCount; ++i) {
+        if (page->Textures[i]) {
+            DUI_uploadFontTexture(page, i, rect);
+        }
+    }
+}
+
+SDL_Texture * DUI_createFontTexture()
+{
+    SDL_Texture * texture = SDL_CreateTexture(_duiRenderer, 
+        SDL_PIXELFORMAT_RGBA32,
+        SDL_TEXTUREACCESS_STATIC,
+        DUI_FONT_ATLAS_SIZE, DUI_FONT_ATLAS_SIZE);
+
+    if (!texture) {
+        return NULL;
+    }
+
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+#if SDL_VERSION_ATLEAST(2, 0, 12)
+    // Distances can be interpolated, unlike coverage
+    if (_duiFont.Spread > 0) {
+        SDL_SetTextureScaleMode(texture, SDL_ScaleModeLinear);
+    }
+#endif
+
+    return texture;
+}
+
+void DUI_destroyFontPage(DUI_FontPage * page)
+{
+    for (int i = 0; i < DUI_FONT_MAX_RAMPS; ++i) {
+        SDL_DestroyTexture(page->Textures[i]);
+        page->Textures[i] = NULL;
+    }
+
+    SDL_free(page->Pixels);
+    page->Pixels = NULL;
+}
+
+DUI_FontPage * DUI_addFontPage()
+{
+    DUI_Font * font = &_duiFont;
+
+    if (font->PageCount == DUI_FONT_MAX_PAGES) {
+        return NULL;
+    }
+
+    DUI_FontPage * page = &font->Pages[font->PageCount];
+    *page = (DUI_FontPage){ .Pixels = NULL };
+
+    page->Pixels = SDL_calloc(DUI_FONT_ATLAS_SIZE * DUI_FONT_ATLAS_SIZE, 1);
+    page->Textures[0] = DUI_createFontTexture();
+
+    if (!page->Pixels || !page->Textures[0]) {
+        DUI_destroyFontPage(page);
+        return NULL;
+    }
+
+    // Clear the texture, so the space around each glyph is transparent
+    SDL_Rect all = { 0, 0, DUI_FONT_ATLAS_SIZE, DUI_FONT_ATLAS_SIZE };
+    DUI_uploadFontPage(page, &all);
+
+    ++font->PageCount;
+    return page;
+}
+
+// Find space for a glyph on the shelf that fits it most closely, or start 
+//   a new shelf, or a new page
+int DUI_packFontGlyph(int width, int height, SDL_Rect * rect)
+{
+    DUI_Font * font = &_duiFont;
+
+    // Leave a pixel between glyphs, so they don't bleed into each other when scaled
+    int paddedWidth = width + 1;
+    int paddedHeight = height + 1;
+
+    if (paddedWidth > DUI_FONT_ATLAS_SIZE || paddedHeight > DUI_FONT_ATLAS_SIZE) {
+        return -1;
+    }
+
+    for (int p = 0; p < font->PageCount; ++p) {
+        DUI_FontPage * page = &font->Pages[p];
+        DUI_FontShelf * best = NULL;
+
+        for (int i = 0; i < page->ShelfCount; ++i) {
+            DUI_FontShelf * shelf = &page->Shelves[i];
+
+            // Don't waste more than a quarter of a shelf's height
+            if (shelf->Height < paddedHeight 
+                || shelf->Height > paddedHeight + (paddedHeight / 4) + 1
+                || shelf->X + paddedWidth > DUI_FONT_ATLAS_SIZE) {
+                continue;
+            }
+
+            if (!best || shelf->Height < best->Height) {
+                best = shelf;
+            }
+        }
+
+        if (!best && page->ShelfCount < DUI_FONT_MAX_SHELVES 
+            && page->Bottom + paddedHeight <= DUI_FONT_ATLAS_SIZE) {
+            best = &page->Shelves[page->ShelfCount++];
+            *best = (DUI_FontShelf){ page->Bottom, paddedHeight, 0 };
+            page->Bottom += paddedHeight;
+        }
+
+        if (best) {
+            *rect = (SDL_Rect){ best->X, best->Y, width, height };
+            best->X += paddedWidth;
+            return p;
+        }
+    }
+
+    if (!DUI_addFontPage()) {
+        return -1;
+    }
+
+    return DUI_packFontGlyph(width, height, rect);
+}
+
+void DUI_addFontGlyph(const DUI_FontGlyph * record)
+{
+    DUI_Font * font = &_duiFont;
+
+    font->Baked[record->Codepoint / 32] |= (1u << (record->Codepoint % 32));
+
+    if (DUI_reserve((void **)&font->Glyphs, &font->GlyphCapacity, 
+            font->GlyphCount + 1, sizeof(DUI_FontGlyph))) {
+        font->Glyphs[font->GlyphCount++] = *record;
+    }
+
+    if (record->Page >= 0) {
+        DUI_Glyph glyph = {
+            .Texture = font->Pages[record->Page].Textures[0],
+            .Src = record->Src,
+            .Left = record->Left,
+            .Top = record->Top,
+            .Width = record->Width,
+            .Height = record->Height,
+        };
+
+        DUI_setGlyph(record->Codepoint, &glyph);
+    }
+    else if (record->Page == DUI_FONT_GLYPH_EMPTY) {
+        DUI_setGlyph(record->Codepoint, &(DUI_Glyph){ .Texture = NULL });
+    }
+    else if (record->Codepoint < DUI_GLYPH_PAGE_SIZE 
+        || _duiGlyphPages[record->Codepoint / DUI_GLYPH_PAGE_SIZE]) {
+        // Missing characters without a page already fall back to '?'
+        DUI_setGlyph(record->Codepoint, &_duiGlyphs['?']);
+    }
+}
+
+void DUI_bakeFontGlyph(uint32_t codepoint)
+{
+    DUI_Font * font = &_duiFont;
+
+    DUI_FontGlyph record = {
+        .Codepoint = codepoint,
+        .Page = DUI_FONT_GLYPH_MISSING,
+    };
+
+    int glyph = DUI_ttFindGlyph(&font->TT, codepoint);
+    int xMin, yMin, xMax, yMax;
+
+    if (glyph == 0) {
+        record.Page = DUI_FONT_GLYPH_MISSING;
+    }
+    else if (!DUI_ttGetGlyphBox(&font->TT, glyph, &xMin, &yMin, &xMax, &yMax)) {
+        record.Page = DUI_FONT_GLYPH_EMPTY;
+    }
+    else {
+        // The glyph's bounds in pixels, relative to its origin on the baseline
+        int left = (int)SDL_floorf(xMin * font->Scale);
+        int right = (int)SDL_ceilf(xMax * font->Scale);
+        int top = (int)SDL_floorf(-yMax * font->Scale);
+        int bottom = (int)SDL_ceilf(-yMin * font->Scale);
+
+        int width = right - left;
+        int height = bottom - top;
+
+        SDL_Rect src;
+        int page = DUI_packFontGlyph(width, height, &src);
+        uint8_t * pixels = SDL_malloc(width * height);
+
+        if (page >= 0 && pixels
+            && DUI_ttRasterize(&font->TT, glyph, font->Scale, 
+                (float)-left, (float)-top, pixels, width, height)) {
+            DUI_FontPage * fontPage = &font->Pages[page];
+
+            for (int y = 0; y < height; ++y) {
+                SDL_memcpy(fontPage->Pixels + ((src.y + y) * DUI_FONT_ATLAS_SIZE) + src.x, 
+                    pixels + (y * width), width);
+            }
+
+            DUI_uploadFontPage(fontPage, &src);
+
+            record.Page = page;
+            record.Src = src;
+            record.Left = (float)left / font->CellWidth;
+            record.Top = (float)(font->Baseline + top) / font->PixelHeight;
+            record.Width = (float)width / font->CellWidth;
+            record.Height = (float)height / font->PixelHeight;
+        }
+
+        SDL_free(pixels);
+    }
+
+    DUI_addFontGlyph(&record);
+    font->Dirty = true;
+}
+
+// Round a height down to one of four steps per power of two, so the ramp
+//   is only rebuilt a few times while text is zoomed
+int DUI_quantizeRampHeight(int height)
+{
+    int power = 1;
+    while (power <= height / 2) {
+        power *= 2;
+    }
+
+    int step = SDL_max(power / 4, 1);
+    return (height / step) * step;
+}
+
+// Build the table of alpha for each value in the atlas, for text drawn
+//   height pixels tall
+void DUI_buildFontRamp(DUI_FontRamp * ramp, int height)
+{
+    DUI_Font * font = &_duiFont;
+
+    height = DUI_quantizeRampHeight(height);
+    ramp->Height = height;
+    ramp->LastUsed = _duiFrame;
+
+    for (int i = 0; i < 256; ++i) {
+        if (font->Spread == 0) {
+            ramp->Alpha[i] = (uint8_t)i;
+            continue;
+        }
+
+        // SDL can't compare each pixel to a threshold, so instead the edge 
+        //   fades over one pixel on screen, however large the text is drawn
+        float distance = ((i - 128) / 127.0f) * font->Spread 
+            * ((float)height / font->PixelHeight);
+        float alpha = SDL_min(SDL_max(distance + 0.5f, 0.0f), 1.0f);
+        ramp->Alpha[i] = (uint8_t)((alpha * 255.0f) + 0.5f);
+    }
+}
+
+// Draw text with the ramp for height, building it if none of the ramps are
+//   for the same step. Pages are only converted with it when first drawn
+void DUI_selectFontRamp(int height)
+{
+    DUI_Font * font = &_duiFont;
+
+    height = DUI_quantizeRampHeight(height);
+
+    int ramp = -1;
+    for (int i = 0; i < font->RampCount; ++i) {
+        if (font->Ramps[i].Height == height) {
+            ramp = i;
+            break;
+        }
+    }
+
+    if (ramp < 0) {
+        if (font->RampCount < DUI_FONT_MAX_RAMPS) {
+            ramp = font->RampCount++;
+        }
+        else {
+            // The first ramp is kept, as glyphs refer to its textures
+            ramp = 1;
+            for (int i = 2; i < font->RampCount; ++i) {
+                if (font->Ramps[i].LastUsed < font->Ramps[ramp].LastUsed) {
+                    ramp = i;
+                }
+            }
+
+            for (int p = 0; p < font->PageCount; ++p) {
+                SDL_DestroyTexture(font->Pages[p].Textures[ramp]);
+                font->Pages[p].Textures[ramp] = NULL;
+            }
+        }
+
+        DUI_buildFontRamp(&font->Ramps[ramp], height);
+    }
+
+    font->Ramps[ramp].LastUsed = _duiFrame;
+
+    if (font->Ramp != ramp) {
+        font->Ramp = ramp;
+        _duiRetainedValid = false;
+    }
+}
+
+// Get the texture to draw a glyph with for the current ramp, converting
+//   the glyph's page if this is the first time it's drawn with the ramp
+SDL_Texture * DUI_getFontTexture(SDL_Texture * texture)
+{
+    DUI_Font * font = &_duiFont;
+
+    if (font->Ramp == 0) {
+        return texture;
+    }
+
+    for (int p = 0; p < font->PageCount; ++p) {
+        DUI_FontPage * page = &font->Pages[p];
+        if (page->Textures[0] != texture) {
+            continue;
+        }
+
+        if (!page->Textures[font->Ramp]) {
+            page->Textures[font->Ramp] = DUI_createFontTexture();
+            if (!page->Textures[font->Ramp]) {
+                return texture;
+            }
+
+            SDL_Rect all = { 0, 0, DUI_FONT_ATLAS_SIZE, DUI_FONT_ATLAS_SIZE };
+            DUI_uploadFontTexture(page, font->Ramp, &all);
+        }
+
+        return page->Textures[font->Ramp];
+    }
+
+    return texture;
+}
+
+void DUI_uploadFontPages()
+{
+    SDL_Rect all = { 0, 0, DUI_FONT_ATLAS_SIZE, DUI_FONT_ATLAS_SIZE };
+
+    for (int p = 0; p < _duiFont.PageCount; ++p) {
+        DUI_uploadFontPage(&_duiFont.Pages[p], &all);
+    }
+}
+
+typedef struct
+{
+    DUI_FontGlyph Record;
+    int Glyph;
+
+    // The glyph's origin, relative to the top-left of Record.Src
+    int OriginX;
+    int OriginY;
+
+} DUI_FontSDFJob;
+
+typedef struct
+{
+    DUI_FontSDFJob * Jobs;
+    size_t JobCount;
+    size_t JobCapacity;
+
+    // The index of the next job to be taken by a thread
+    SDL_atomic_t Next;
+
+} DUI_FontSDFWork;
+
+// Find space in the atlas for a glyph's distance field
+void DUI_addFontSDFJob(DUI_FontSDFWork * work, uint32_t codepoint)
+{
+    DUI_Font * font = &_duiFont;
+
+    int glyph = DUI_ttFindGlyph(&font->TT, codepoint);
+
+    // Missing characters without a page already fall back to '?'
+    if (glyph == 0 && codepoint >= DUI_GLYPH_PAGE_SIZE) {
+        return;
+    }
+
+    if (!DUI_reserve((void **)&work->Jobs, &work->JobCapacity, 
+            work->JobCount + 1, sizeof(DUI_FontSDFJob))) {
+        return;
+    }
+
+    DUI_FontSDFJob * job = &work->Jobs[work->JobCount++];
+    *job = (DUI_FontSDFJob){
+        .Record = { .Codepoint = codepoint, .Page = DUI_FONT_GLYPH_MISSING },
+        .Glyph = glyph,
+    };
+
+    int xMin, yMin, xMax, yMax;
+
+    if (glyph == 0) {
+        return;
+    }
+
+    if (!DUI_ttGetGlyphBox(&font->TT, glyph, &xMin, &yMin, &xMax, &yMax)) {
+        job->Record.Page = DUI_FONT_GLYPH_EMPTY;
+        return;
+    }
+
+    // The glyph's bounds in pixels, relative to its origin on the baseline,
+    //   with room for the distances outside the outline
+    int left = (int)SDL_floorf(xMin * font->Scale) - font->Spread;
+    int right = (int)SDL_ceilf(xMax * font->Scale) + font->Spread;
+    int top = (int)SDL_floorf(-yMax * font->Scale) - font->Spread;
+    int bottom = (int)SDL_ceilf(-yMin * font->Scale) + font->Spread;
+
+    int width = right - left;
+    int height = bottom - top;
+
+    SDL_Rect src;
+    int page = DUI_packFontGlyph(width, height, &src);
+    if (page < 0) {
+        return;
+    }
+
+    job->OriginX = -left;
+    job->OriginY = -top;
+
+    job->Record.Page = page;
+    job->Record.Src = src;
+    job->Record.Left = (float)left / font->CellWidth;
+    job->Record.Top = (float)(font->Baseline + top) / font->PixelHeight;
+    job->Record.Width = (float)width / font->CellWidth;
+    job->Record.Height = (float)height / font->PixelHeight;
+}
+
+int DUI_generateFontSDFThread(void * data)
+{
+    DUI_FontSDFWork * work = data;
+    DUI_Font * font = &_duiFont;
+
+    for (;;) {
+        size_t index = (size_t)SDL_AtomicAdd(&work->Next, 1);
+        if (index >= work->JobCount) {
+            break;
+        }
+
+        DUI_FontSDFJob * job = &work->Jobs[index];
+        if (job->Record.Page < 0) {
+            continue;
+        }
+
+        // Each job has its own area of the page, so threads can write to
+        //   it at the same time
+        const SDL_Rect * src = &job->Record.Src;
+        uint8_t * pixels = font->Pages[job->Record.Page].Pixels 
+            + (src->y * DUI_FONT_ATLAS_SIZE) + src->x;
+
+        if (!DUI_ttRasterizeSDF(&font->TT, job->Glyph, font->Scale, 
+                (float)job->OriginX, (float)job->OriginY, (float)font->Spread,
+                pixels, DUI_FONT_ATLAS_SIZE, src->w, src->h)) {
+            job->Record.Page = DUI_FONT_GLYPH_MISSING;
+        }
+    }
+
+    return 0;
+}
+
+// Rasterize the distance field of every glyph in the font
+void DUI_generateFontSDF()
+{
+    DUI_Font * font = &_duiFont;
+    DUI_FontSDFWork work = { 0 };
+
+    // The atlas is packed in advance, so the glyphs can be rasterized in
+    //   any order. '?' is added first, to be used for missing characters
+    DUI_addFontSDFJob(&work, '?');
+
+    uint32_t c = 0;
+    while (c < 0x110000) {
+        if (c != '?') {
+            DUI_addFontSDFJob(&work, c);
+        }
+
+        // Only the first page needs every character, the rest fall back to '?'
+        c = (c + 1 < DUI_GLYPH_PAGE_SIZE ? c + 1 : DUI_ttNextCodepoint(&font->TT, c + 1));
+    }
+
+    int threadCount = SDL_min(SDL_max(SDL_GetCPUCount(), 1), DUI_FONT_SDF_MAX_THREADS);
+    SDL_Thread * threads[DUI_FONT_SDF_MAX_THREADS] = { NULL };
+
+    for (int i = 1; i < threadCount; ++i) {
+        threads[i] = SDL_CreateThread(DUI_generateFontSDFThread, "DUI_FontSDF", &work);
+    }
+
+    // This thread takes jobs too, and does them all if no threads started
+    DUI_generateFontSDFThread(&work);
+
+    for (int i = 1; i < threadCount; ++i) {
+        SDL_WaitThread(threads[i], NULL);
+    }
+
+    DUI_uploadFontPages();
+
+    for (size_t i = 0; i < work.JobCount; ++i) {
+        DUI_addFontGlyph(&work.Jobs[i].Record);
+    }
+
+    SDL_free(work.Jobs);
+    font->Dirty = true;
+}
+
+// Check that a page read from a cache file only packs glyphs inside the atlas
+bool DUI_isFontPageValid(const DUI_FontPage * page)
+{
+    if (page->Bottom < 0 || page->Bottom > DUI_FONT_ATLAS_SIZE) {
+        return false;
+    }
+
+    for (int i = 0; i < page->ShelfCount; ++i) {
+        const DUI_FontShelf * shelf = &page->Shelves[i];
+
+        if (shelf->Y < 0 || shelf->Height <= 0 || shelf->Height > page->Bottom - shelf->Y
+            || shelf->X < 0 || shelf->X > DUI_FONT_ATLAS_SIZE) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool DUI_isFontGlyphValid(const DUI_FontGlyph * record)
+{
+    if (record->Codepoint >= 0x110000) {
+        return false;
+    }
+
+    if (record->Page < 0) {
+        return (record->Page == DUI_FONT_GLYPH_EMPTY || record->Page == DUI_FONT_GLYPH_MISSING);
+    }
+
+    const SDL_Rect * src = &record->Src;
+    return (record->Page < _duiFont.PageCount
+        && src->x >= 0 && src->w >= 0 && src->w <= DUI_FONT_ATLAS_SIZE - src->x
+        && src->y >= 0 && src->h >= 0 && src->h <= DUI_FONT_ATLAS_SIZE - src->y);
+}
+
+// Describe the size of each struct written to the cache file
+uint32_t DUI_getFontCacheLayout()
+{
+    return (uint32_t)((sizeof(DUI_FontCacheHeader) << 16) 
+        | (sizeof(DUI_FontGlyph) << 8) 
+        | sizeof(DUI_FontShelf));
+}
+
+bool DUI_readFontCache(const char * path)
+{
+    DUI_Font * font = &_duiFont;
+
+    SDL_RWops * file = SDL_RWFromFile(path, "rb");
+    if (!file) {
+        return false;
+    }
+
+    DUI_FontCacheHeader header;
+    bool valid = (SDL_RWread(file, &header, sizeof(header), 1) == 1)
+        && SDL_memcmp(header.Magic, "DUIF", 4) == 0
+        && header.Version == DUI_FONT_CACHE_VERSION
+        && header.ByteOrder == DUI_FONT_CACHE_BYTE_ORDER
+        && header.Layout == DUI_getFontCacheLayout()
+        && header.FontHash == font->Hash
+        && header.PixelHeight == font->PixelHeight
+        && header.Spread == font->Spread
+        && header.AtlasSize == DUI_FONT_ATLAS_SIZE
+        && header.PageCount >= 0 && header.PageCount <= DUI_FONT_MAX_PAGES
+        && header.GlyphCount >= 0 && header.GlyphCount <= 0x110000;
+
+    DUI_FontGlyph * records = NULL;
+    if (valid && header.GlyphCount > 0) {
+        records = SDL_malloc(header.GlyphCount * sizeof(DUI_FontGlyph));
+        valid = records 
+            && SDL_RWread(file, records, sizeof(DUI_FontGlyph), header.GlyphCount) == (size_t)header.GlyphCount;
+    }
+
+    for (int p = 0; p < header.PageCount && valid; ++p) {
+        DUI_FontPage * page = DUI_addFontPage();
+        if (!page) {
+            valid = false;
+            break;
+        }
+
+        valid = SDL_RWread(file, &page->ShelfCount, sizeof(int32_t), 1) == 1
+            && SDL_RWread(file, &page->Bottom, sizeof(int32_t), 1) == 1
+            && page->ShelfCount >= 0 && page->ShelfCount <= DUI_FONT_MAX_SHELVES
+            && (page->ShelfCount == 0 
+                || SDL_RWread(file, page->Shelves, sizeof(DUI_FontShelf), page->ShelfCount) == (size_t)page->ShelfCount)
+            && DUI_isFontPageValid(page)
+            && SDL_RWread(file, page->Pixels, DUI_FONT_ATLAS_SIZE, DUI_FONT_ATLAS_SIZE) == DUI_FONT_ATLAS_SIZE;
+
+        if (!valid) {
+            break;
+        }
+
+        SDL_Rect all = { 0, 0, DUI_FONT_ATLAS_SIZE, DUI_FONT_ATLAS_SIZE };
+        DUI_uploadFontPage(page, &all);
+    }
+
+    SDL_RWclose(file);
+
+    for (int i = 0; i < header.GlyphCount && valid; ++i) {
+        if (DUI_isFontGlyphValid(&records[i])) {
+            DUI_addFontGlyph(&records[i]);
+        }
+    }
+
+    SDL_free(records);
+
+    if (!valid) {
+        // Start again with no pages, rather than pack into the shelves read
+        for (int p = 0; p < font->PageCount; ++p) {
+            DUI_destroyFontPage(&font->Pages[p]);
+        }
+
+        font->PageCount = 0;
+    }
+
+    return valid;
+}
+
+void DUI_writeFontCache()
+{
+    DUI_Font * font = &_duiFont;
+
+    if (!font->CachePath || !font->Dirty) {
+        return;
+    }
+
+    SDL_RWops * file = SDL_RWFromFile(font->CachePath, "wb");
+    if (!file) {
+        return;
+    }
+
+    DUI_FontCacheHeader header = {
+        .Magic = { 'D', 'U', 'I', 'F' },
+        .Version = DUI_FONT_CACHE_VERSION,
+        .ByteOrder = DUI_FONT_CACHE_BYTE_ORDER,
+        .Layout = DUI_getFontCacheLayout(),
+        .FontHash = font->Hash,
+        .PixelHeight = font->PixelHeight,
+        .Spread = font->Spread,
+        .AtlasSize = DUI_FONT_ATLAS_SIZE,
+        .PageCount = font->PageCount,
+        .GlyphCount = (int32_t)font->GlyphCount,
+    };
+
+    SDL_RWwrite(file, &header, sizeof(header), 1);
+    SDL_RWwrite(file, font->Glyphs, sizeof(DUI_FontGlyph), font->GlyphCount);
+
+    for (int p = 0; p < font->PageCount; ++p) {
+        const DUI_FontPage * page = &font->Pages[p];
+
+        SDL_RWwrite(file, &page->ShelfCount, sizeof(int32_t), 1);
+        SDL_RWwrite(file, &page->Bottom, sizeof(int32_t), 1);
+        SDL_RWwrite(file, page->Shelves, sizeof(DUI_FontShelf), page->ShelfCount);
+        SDL_RWwrite(file, page->Pixels, DUI_FONT_ATLAS_SIZE, DUI_FONT_ATLAS_SIZE);
+    }
+
+    SDL_RWclose(file);
+    font->Dirty = false;
+}
+
+// Free the font, and go back to the built-in font
+void DUI_freeFont()
+{
+    DUI_Font * font = &_duiFont;
+
+    if (!font->Data) {
+        return;
+    }
+
+    for (int p = 0; p < font->PageCount; ++p) {
+        DUI_destroyFontPage(&font->Pages[p]);
+    }
+
+    SDL_free(font->Baked);
+    SDL_free(font->Glyphs);
+    SDL_free(font->CachePath);
+    SDL_free(font->Data);
+    *font = (DUI_Font){ .Data = NULL };
+
+    DUI_freeGlyphPages();
+    DUI_buildGlyphTable();
+    DUI_applyUserGlyphs();
+
+    _duiStyle.CharWidth = DUI_FONT_CHAR_WIDTH;
+    _duiStyle.CharHeight = DUI_FONT_CHAR_HEIGHT;
+}
+
+// Set the glyphs added with DUI_AddGlyph again, and keep the font from 
+//   replacing them
+void DUI_keepUserGlyphs()
+{
+    DUI_applyUserGlyphs();
+
+    for (size_t i = 0; i < _duiUserGlyphCount; ++i) {
+        uint32_t codepoint = _duiUserGlyphs[i].Codepoint;
+        _duiFont.Baked[codepoint / 32] |= (1u << (codepoint % 32));
+    }
+}
+
+#endif // DUI_TRUETYPE
+
+const DUI_Glyph * DUI_lookupGlyph(uint32_t codepoint)
+{
+    if (codepoint >= 0x110000) {
+        return &_duiGlyphs['?'];
+    }
+
+#if defined(DUI_TRUETYPE)
+    if (_duiFont.Data && !DUI_isFontGlyphBaked(codepoint)) {
+        DUI_bakeFontGlyph(codepoint);
+    }
+#endif
+
+    const DUI_Glyph * page = _duiGlyphPages[codepoint / DUI_GLYPH_PAGE_SIZE];
+    if (!page) {
+        return &_duiGlyphs['?'];
+    }
+
+    return &page[codepoint % DUI_GLYPH_PAGE_SIZE];
+}
+
+// Draw each character of the text with its glyph from the font
+void DUI_drawGlyphs(const unsigned char * text, size_t length, const SDL_Rect * bounds, 
+    int charWidth, const uint8_t color[4])
+{
+    SDL_Rect dst = { 
+        .x = bounds->x,
+        .y = bounds->y,
+        .w = charWidth,
+        .h = bounds->h,
+    };
+
+    // The texture of the last glyph, and the texture it is drawn with
+    SDL_Texture * last = NULL;
+    SDL_Texture * texture = NULL;
+
+    for (size_t i = 0; i < length; ) {
+        const DUI_Glyph * glyph;
+
+        // ASCII skips decoding and the page table
+        if (text[i] < 0x80) {
+            glyph = &_duiGlyphs[text[i]];
+            ++i;
+        }
+        else {
+            glyph = DUI_lookupGlyph(DUI_decodeUTF8(text, length, &i));
+        }
+
+        if (glyph->Texture != last) {
+            last = glyph->Texture;
+            texture = last;
+
+#if defined(DUI_TRUETYPE)
+            texture = DUI_getFontTexture(texture);
+#endif
+        }
+
+        if (glyph->Texture && glyph->Width > 0.0f) {
+            // Round the edges rather than the size, so adjacent glyphs line up
+            int left = dst.x + (int)SDL_floorf((glyph->Left * charWidth) + 0.5f);
+            int top = dst.y + (int)SDL_floorf((glyph->Top * dst.h) + 0.5f);
+            int right = dst.x + (int)SDL_floorf(((glyph->Left + glyph->Width) * charWidth) + 0.5f);
+            int bottom = dst.y + (int)SDL_floorf(((glyph->Top + glyph->Height) * dst.h) + 0.5f);
+
+            SDL_Rect area = { left, top, right - left, bottom - top };
+            DUI_pushGlyph(texture, &glyph->Src, &area, color);
+        }
+        else if (glyph->Texture) {
+            DUI_pushGlyph(texture, &glyph->Src, &dst, color);
+        }
+
+        dst.x += charWidth;
+    }
+}
+
+void DUI_renderText(const DUI_DrawCommand * command, const SDL_Rect * bounds)
+{
+    const unsigned char * text = (const unsigned char *)_duiDrawList.Text + command->Offset;
+
+    // Lines in the text cache are drawn with a single quad
+    if (_duiTextCacheCommands && command >= _duiTextCacheCommands 
+        && command < _duiTextCacheCommands + _duiTextCacheCount) {
+        int index = _duiTextCacheLookups[command - _duiTextCacheCommands];
+
+        if (index >= 0) {
+            DUI_TextCacheEntry * entry = &_duiTextCache[index];
+            DUI_pushGlyph(_duiTextCachePages[entry->Page].Texture, 
+                &entry->Src, bounds, command->Color);
+            return;
+        }
+    }
+
+    DUI_drawGlyphs(text, command->Length, bounds, command->CharWidth, command->Color);
+}
+
+uint64_t DUI_hash(const void * data, size_t size, uint64_t hash)
+{
+    const uint8_t * bytes = (const uint8_t *)data;
+    const uint64_t K = 0x9E3779B97F4A7C15ull;
+
+    while (size >= sizeof(uint64_t)) {
+        uint64_t word;
+        SDL_memcpy(&word, bytes, sizeof(word));
+        hash = (((hash << 5) | (hash >> 59)) ^ word) * K;
+
+        bytes += sizeof(uint64_t);
+        size -= sizeof(uint64_t);
+    }
+
+    if (size > 0) {
+        uint64_t word = 0;
+        SDL_memcpy(&word, bytes, size);
+        hash = (((hash << 5) | (hash >> 59)) ^ word) * K;
+    }
+
+    hash ^= (hash >> 32);
+    return hash;
+}
+
+void DUI_setTargetBlendMode(SDL_Texture * texture)
+{
+    // Render targets hold colors that have already been multiplied by their
+    //   alpha, so they need to be copied without multiplying again
+    SDL_BlendMode premultiplied = SDL_ComposeCustomBlendMode(
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+
+    if (SDL_SetTextureBlendMode(texture, premultiplied) < 0) {
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    }
+}
+
+int DUI_targetSize(int size)
+{
+    size += (size * DUI_TARGET_HEADROOM) / 100;
+    return ((size + DUI_TARGET_GRANULARITY - 1) / DUI_TARGET_GRANULARITY) 
+        * DUI_TARGET_GRANULARITY;
+}
+
+DUI_PooledTarget * DUI_acquireTarget(int width, int height)
+{
+    if (width <= 0 || height <= 0) {
+        return NULL;
+    }
+
+    DUI_PooledTarget * best = NULL;
+    DUI_PooledTarget * empty = NULL;
+    DUI_PooledTarget * oldest = NULL;
+
+    for (int i = 0; i < DUI_TARGET_POOL_SIZE; ++i) {
+        DUI_PooledTarget * target = &_duiTargetPool[i];
+
+        if (target->InUse) {
+            continue;
+        }
+
+        if (!target->Texture) {
+            if (!empty) {
+                empty = target;
+            }
+            continue;
+        }
+
+        if (target->Width >= width && target->Height >= height) {
+            if (!best || (target->Width * target->Height) < (best->Width * best->Height)) {
+                best = target;
+            }
+        }
+
+        if (!oldest || target->LastUsed < oldest->LastUsed) {
+            oldest = target;
+        }
+    }
+
+    if (!best) {
+        best = (empty ? empty : oldest);
+        if (!best) {
+            return NULL;
+        }
+
+        SDL_DestroyTexture(best->Texture);
+
+        best->Width = DUI_targetSize(width);
+        best->Height = DUI_targetSize(height);
+
+        best->Texture = SDL_CreateTexture(_duiRenderer, 
+            SDL_PIXELFORMAT_RGBA32,
+            SDL_TEXTUREACCESS_TARGET,
+            best->Width, best->Height);
+
+        if (!best->Texture) {
+            return NULL;
+        }
+
+        DUI_setTargetBlendMode(best->Texture);
+    }
+
+    best->InUse = true;
+    best->LastUsed = _duiFrame;
+    return best;
+}
+
+void DUI_releaseTarget(DUI_PooledTarget * target)
+{
+    target->InUse = false;
+    target->LastUsed = _duiFrame;
+}
+
+void DUI_trimTargetPool()
+{
+    for (int i = 0; i < DUI_TARGET_POOL_SIZE; ++i) {
+        DUI_PooledTarget * target = &_duiTargetPool[i];
+
+        if (target->Texture && !target->InUse 
+            && (_duiFrame - target->LastUsed) > DUI_TARGET_POOL_TIMEOUT) {
+            SDL_DestroyTexture(target->Texture);
+            *target = (DUI_PooledTarget){ .Texture = NULL };
+        }
+    }
+}
+
+int DUI_getTextCacheEntry(uint64_t key)
+{
+    int first = (key & ((DUI_TEXT_CACHE_ENTRIES / DUI_TEXT_CACHE_WAYS) - 1)) 
+        * DUI_TEXT_CACHE_WAYS;
+
+    int victim = -1;
+    for (int i = first; i < first + DUI_TEXT_CACHE_WAYS; ++i) {
+        DUI_TextCacheEntry * entry = &_duiTextCache[i];
+
+        if (entry->Key == key) {
+            return i;
+        }
+
+        // Entries used this frame are referenced by _duiTextCacheLookups
+        if (entry->Key != 0 && entry->LastUsed == _duiFrame) {
+            continue;
+        }
+
+        if (victim < 0 || entry->Key == 0 
+            || (_duiTextCache[victim].Key != 0 && entry->LastUsed < _duiTextCache[victim].LastUsed)) {
+            victim = i;
+        }
+    }
+
+    if (victim < 0) {
+        return -1;
+    }
+
+    DUI_TextCacheEntry * entry = &_duiTextCache[victim];
+    if (entry->Page >= 0 && entry->Key != 0) {
+        ++_duiTextCacheStats.Evictions;
+    }
+
+    *entry = (DUI_TextCacheEntry){
+        .Key = key,
+        .Page = -1,
+        .FirstSeen = _duiFrame,
+        .LastUsed = _duiFrame,
+    };
+
+    return victim;
+}
+
+void DUI_clearTextCachePage(int page)
+{
+    DUI_TextCachePage * cachePage = &_duiTextCachePages[page];
+
+    for (int i = 0; i < DUI_TEXT_CACHE_ENTRIES; ++i) {
+        if (_duiTextCache[i].Key != 0 && _duiTextCache[i].Page == page) {
+            _duiTextCache[i].Page = -1;
+            ++_duiTextCacheStats.Evictions;
+        }
+    }
+
+    cachePage->ShelfX = 0;
+    cachePage->ShelfY = 0;
+    cachePage->ShelfHeight = 0;
+}
+
+bool DUI_allocTextCacheSpace(int page, int width, int height, SDL_Rect * src)
+{
+    DUI_TextCachePage * cachePage = &_duiTextCachePages[page];
+
+    if (cachePage->ShelfX + width > DUI_TEXT_CACHE_PAGE_SIZE) {
+        cachePage->ShelfX = 0;
+        cachePage->ShelfY += cachePage->ShelfHeight;
+        cachePage->ShelfHeight = 0;
+    }
+
+    if (cachePage->ShelfY + height > DUI_TEXT_CACHE_PAGE_SIZE) {
+        return false;
+    }
+
+    *src = (SDL_Rect){ cachePage->ShelfX, cachePage->ShelfY, width, height };
+
+    cachePage->ShelfX += width;
+    cachePage->ShelfHeight = SDL_max(cachePage->ShelfHeight, height);
+    return true;
+}
+
+// Find space for a line of text, creating or clearing a page if needed
+int DUI_allocTextCache(int width, int height, SDL_Rect * src)
+{
+    if (width > DUI_TEXT_CACHE_PAGE_SIZE || height > DUI_TEXT_CACHE_PAGE_SIZE) {
+        return -1;
+    }
+
+    int maxPages = SDL_min(DUI_TEXT_CACHE_MAX_PAGES, 
+        (int)(_duiTextCacheBudget / DUI_TEXT_CACHE_PAGE_BYTES));
+
+    int empty = -1;
+    int oldest = -1;
+    for (int i = 0; i < maxPages; ++i) {
+        DUI_TextCachePage * cachePage = &_duiTextCachePages[i];
+
+        if (!cachePage->Texture) {
+            if (empty < 0) {
+                empty = i;
+            }
+            continue;
+        }
+
+        if (DUI_allocTextCacheSpace(i, width, height, src)) {
+            return i;
+        }
+
+        if (cachePage->LastUsed != _duiFrame 
+            && (oldest < 0 || cachePage->LastUsed < _duiTextCachePages[oldest].LastUsed)) {
+            oldest = i;
+        }
+    }
+
+    int page = (empty >= 0 ? empty : oldest);
+    if (page < 0) {
+        return -1;
+    }
+
+    DUI_TextCachePage * cachePage = &_duiTextCachePages[page];
+
+    if (!cachePage->Texture) {
+        cachePage->Texture = SDL_CreateTexture(_duiRenderer, 
+            SDL_PIXELFORMAT_RGBA32,
+            SDL_TEXTUREACCESS_TARGET,
+            DUI_TEXT_CACHE_PAGE_SIZE, DUI_TEXT_CACHE_PAGE_SIZE);
+
+        if (!cachePage->Texture) {
+            return -1;
+        }
+
+        DUI_setTargetBlendMode(cachePage->Texture);
+        _duiTextCacheStats.Bytes += DUI_TEXT_CACHE_PAGE_BYTES;
+    }
+    else {
+        DUI_clearTextCachePage(page);
+    }
+
+    DUI_setRenderTarget(cachePage->Texture);
+    DUI_setRenderDrawColor(0x00, 0x00, 0x00, 0x00);
+    SDL_RenderClear(_duiRenderer);
+
+    if (!DUI_allocTextCacheSpace(page, width, height, src)) {
+        return -1;
+    }
+
+    return page;
+}
+
+void DUI_destroyTextCachePages(int first)
+{
+    for (int i = first; i < DUI_TEXT_CACHE_MAX_PAGES; ++i) {
+        DUI_TextCachePage * cachePage = &_duiTextCachePages[i];
+
+        if (cachePage->Texture) {
+            DUI_clearTextCachePage(i);
+
+            SDL_DestroyTexture(cachePage->Texture);
+            cachePage->Texture = NULL;
+            _duiTextCacheStats.Bytes -= DUI_TEXT_CACHE_PAGE_BYTES;
+        }
+    }
+}
+
+// Look up every line of text about to be replayed, and draw the lines 
+//   that were also drawn on a previous frame into the cache
+void DUI_prepareTextCache(const DUI_DrawCommand * commands, size_t count)
+{
+    _duiTextCacheFrame = _duiFrame;
+    _duiTextCacheCommands = NULL;
+
+    if (_duiTextCacheBudget < DUI_TEXT_CACHE_PAGE_BYTES) {
+        return;
+    }
+
+    if (!DUI_reserve((void **)&_duiTextCacheLookups, &_duiTextCacheLookupCapacity, 
+            count, sizeof(int))) {
+        return;
+    }
+
+    _duiTextCacheCommands = commands;
+    _duiTextCacheCount = count;
+
+    DUI_RenderState saved;
+    bool drawing = false;
+
+    for (size_t i = 0; i < count; ++i) {
+        const DUI_DrawCommand * command = &commands[i];
+        _duiTextCacheLookups[i] = -1;
+
+        if (command->Type != DUI_COMMAND_TEXT || command->Length < DUI_TEXT_CACHE_MIN_LENGTH) {
+            continue;
+        }
+
+        const char * text = _duiDrawList.Text + command->Offset;
+
+        uint64_t key = DUI_hash(text, command->Length, 
+            command->CharWidth 
+            | ((uint64_t)command->Bounds.h << 16) 
+            | ((uint64_t)_duiGlyphGeneration << 32));
+        if (key == 0) {
+            key = 1;
+        }
+
+        int index = DUI_getTextCacheEntry(key);
+        if (index < 0) {
+            ++_duiTextCacheStats.Misses;
+            continue;
+        }
+
+        DUI_TextCacheEntry * entry = &_duiTextCache[index];
+        entry->LastUsed = _duiFrame;
+
+        if (entry->Page < 0 && entry->FirstSeen != _duiFrame) {
+            if (!drawing) {
+                DUI_flushGlyphs();
+
+                saved = _duiRenderState;
+                drawing = true;
+            }
+
+            entry->Page = DUI_allocTextCache(command->Bounds.w, command->Bounds.h, &entry->Src);
+
+            if (entry->Page >= 0) {
+                DUI_DrawCommand bake = *command;
+                bake.Bounds = entry->Src;
+                SDL_memcpy(bake.Color, DUI_TEXT_COLOR, sizeof(bake.Color));
+
+                DUI_setRenderTarget(_duiTextCachePages[entry->Page].Texture);
+
+                // Draw the text character by character, into the cache
+                const DUI_DrawCommand * lookups = _duiTextCacheCommands;
+                _duiTextCacheCommands = NULL;
+                DUI_renderText(&bake, &bake.Bounds);
+                DUI_flushGlyphs();
+                _duiTextCacheCommands = lookups;
+            }
+        }
+
+        if (entry->Page >= 0) {
+            _duiTextCachePages[entry->Page].LastUsed = _duiFrame;
+            _duiTextCacheLookups[i] = index;
+            ++_duiTextCacheStats.Hits;
+        }
+        else {
+            ++_duiTextCacheStats.Misses;
+        }
+    }
+
+    if (drawing) {
+        DUI_setRenderTarget(saved.Target);
+        DUI_setRenderClip(saved.HasClip ? &saved.Clip : NULL);
+    }
+}
+
+DUI_DrawCommand * DUI_sortCommands()
+{
+    DUI_DrawList * list = &_duiDrawList;
+
+    // With only one layer recorded, the commands are already in order
+    if ((list->Layers & (list->Layers - 1)) == 0) {
+        return list->Commands;
+    }
+
+    if (!DUI_reserve((void **)&list->Sorted, &list->SortedCapacity,
+            list->CommandCount, sizeof(DUI_DrawCommand))) {
+        return list->Commands;
+    }
+
+    size_t next = 0;
+    for (int layer = 0; layer < DUI_LAYER_COUNT; ++layer) {
+        if (!(list->Layers & (1u << layer))) {
+            continue;
+        }
+
+        for (size_t i = 0; i < list->CommandCount; ++i) {
+            if (list->Commands[i].Layer == layer) {
+                list->Sorted[next] = list->Commands[i];
+                ++next;
+            }
+        }
+    }
+
+    return list->Sorted;
+}
+
+#if defined(_MSC_VER)
+#   define DUI_THREAD_LOCAL __declspec(thread)
+#else
+#   define DUI_THREAD_LOCAL _Thread_local
+#endif
+
+#ifndef DUI_PROFILE_MAX_THREADS
+#   define DUI_PROFILE_MAX_THREADS (8)
+#endif // DUI_PROFILE_MAX_THREADS
+
+// The number of scopes kept for each thread, must be a power of two
+#ifndef DUI_PROFILE_RING_SIZE
+#   define DUI_PROFILE_RING_SIZE (2048)
+#endif // DUI_PROFILE_RING_SIZE
+
+#ifndef DUI_PROFILE_MAX_FRAMES
+#   define DUI_PROFILE_MAX_FRAMES (120)
+#endif // DUI_PROFILE_MAX_FRAMES
+
+// Scopes nested deeper than this are not recorded
+#define DUI_PROFILE_MAX_DEPTH (32)
+
+typedef struct
+{
+    const char * Name;
+    uint64_t Start;
+
+    // 0 until the scope has ended
+    uint64_t End;
+
+    int Depth;
+
+} DUI_ProfileEvent;
+
+typedef struct
+{
+    DUI_ProfileEvent Events[DUI_PROFILE_RING_SIZE];
+
+    // The number of scopes begun, updated after each event is written
+    SDL_atomic_t Head;
+
+    // The position of each open scope in Events
+    uint32_t Stack[DUI_PROFILE_MAX_DEPTH];
+    int Depth;
+
+    SDL_threadID ThreadID;
+
+    // Set once ThreadID is written, before then the thread is not read
+    SDL_atomic_t Ready;
+
+} DUI_ProfileThread;
+
+DUI_ProfileThread _duiProfileThreads[DUI_PROFILE_MAX_THREADS];
+SDL_atomic_t _duiProfileThreadCount = { 0 };
+
+// Claimed by the first call to DUI_ProfileBegin on each thread
+DUI_THREAD_LOCAL DUI_ProfileThread * _duiProfileThread = NULL;
+DUI_THREAD_LOCAL bool _duiProfileThreadFull = false;
+
+// The time each frame began, written by DUI_Update
+uint64_t _duiProfileFrames[DUI_PROFILE_MAX_FRAMES];
+uint32_t _duiProfileFrameCount = 0;
+
+#ifndef DUI_PROFILE_DUMP_PATH
+#   define DUI_PROFILE_DUMP_PATH "dui_trace.json"
+#endif // DUI_PROFILE_DUMP_PATH
+
+// Set by DUI_eventWatch when DUI_PROFILE_DUMP_KEY is pressed, and applied
+//   in DUI_Update
+SDL_atomic_t _duiProfileDumpPending = { 0 };
+
+SDL_Thread * _duiProfileDumpThread = NULL;
+
+// Set while a dump is being written
+SDL_atomic_t _duiProfileDumpBusy = { 0 };
+
+typedef struct
+{
+    const char * Name;
+    uint64_t Start;
+    uint64_t End;
+    SDL_threadID ThreadID;
+
+} DUI_TraceEvent;
+
+// The scopes copied by DUI_ProfilerDump, owned by the thread writing them
+//   while _duiProfileDumpBusy is set
+typedef struct
+{
+    SDL_RWops * File;
+
+    DUI_TraceEvent * Events;
+    size_t EventCount;
+    size_t EventCapacity;
+
+    uint64_t Frames[DUI_PROFILE_MAX_FRAMES];
+    int FrameCount;
+
+    // Every time is written relative to this
+    uint64_t Origin;
+
+    char Buffer[64 * 1024];
+    size_t Length;
+
+} DUI_TraceDump;
+
+// Allocated by the first dump, and reused by the next
+DUI_TraceDump * _duiProfileDump = NULL;
+
+DUI_ProfileThread * DUI_getProfileThread()
+{
+    if (!_duiProfileThread && !_duiProfileThreadFull) {
+        int index = SDL_AtomicAdd(&_duiProfileThreadCount, 1);
+
+        if (index < DUI_PROFILE_MAX_THREADS) {
+            _duiProfileThread = &_duiProfileThreads[index];
+            _duiProfileThread->ThreadID = SDL_ThreadID();
+            SDL_AtomicSet(&_duiProfileThread->Ready, 1);
+        }
+        else {
+            SDL_AtomicAdd(&_duiProfileThreadCount, -1);
+            _duiProfileThreadFull = true;
+        }
+    }
+
+    return _duiProfileThread;
+}
+
+#ifndef DUI_CHANNEL_MAX_THREADS
+#   define DUI_CHANNEL_MAX_THREADS (64)
+#endif // DUI_CHANNEL_MAX_THREADS
+
+// The number of values each thread can publish between calls to 
+//   DUI_Update, must be a power of two
+#ifndef DUI_CHANNEL_QUEUE_SIZE
+#   define DUI_CHANNEL_QUEUE_SIZE (1024)
+#endif // DUI_CHANNEL_QUEUE_SIZE
+
+// Must be a power of two
+#ifndef DUI_CHANNEL_MAX_BINDINGS
+#   define DUI_CHANNEL_MAX_BINDINGS (256)
+#endif // DUI_CHANNEL_MAX_BINDINGS
+
+#define DUI_CACHE_LINE_SIZE (64)
+
+typedef struct
+{
+    uint32_t ID;
+    float Value;
+    uint64_t Timestamp;
+
+} DUI_ChannelRecord;
+
+typedef struct
+{
+    // Written only by the thread that claimed the queue
+    SDL_atomic_t Head;
+    SDL_atomic_t Dropped;
+    uint8_t HeadPadding[DUI_CACHE_LINE_SIZE - (sizeof(SDL_atomic_t) * 2)];
+
+    // Written only by DUI_Update
+    SDL_atomic_t Tail;
+    uint8_t TailPadding[DUI_CACHE_LINE_SIZE - sizeof(SDL_atomic_t)];
+
+    DUI_ChannelRecord Records[DUI_CHANNEL_QUEUE_SIZE];
+
+} DUI_ChannelQueue;
+
+DUI_ChannelQueue _duiChannelQueues[DUI_CHANNEL_MAX_THREADS];
+SDL_atomic_t _duiChannelQueueCount = { 0 };
+
+// Claimed by the first call to DUI_ChannelPush on each thread
+DUI_THREAD_LOCAL DUI_ChannelQueue * _duiChannelQueue = NULL;
+DUI_THREAD_LOCAL bool _duiChannelQueueFull = false;
+
+typedef struct
+{
+    bool Bound;
+    uint32_t ID;
+    DUI_Series * Series;
+
+    bool HasValue;
+    float Value;
+    uint64_t Timestamp;
+
+} DUI_ChannelBinding;
+
+// Open addressed, indexed by a hash of the ID
+DUI_ChannelBinding _duiChannelBindings[DUI_CHANNEL_MAX_BINDINGS];
+int _duiChannelBindingCount = 0;
+
+DUI_ChannelQueue * DUI_getChannelQueue()
+{
+    if (!_duiChannelQueue && !_duiChannelQueueFull) {
+        int index = SDL_AtomicAdd(&_duiChannelQueueCount, 1);
+
+        if (index < DUI_CHANNEL_MAX_THREADS) {
+            _duiChannelQueue = &_duiChannelQueues[index];
+        }
+        else {
+            SDL_AtomicAdd(&_duiChannelQueueCount, -1);
+            _duiChannelQueueFull = true;
+        }
+    }
+
+    return _duiChannelQueue;
+}
+
+// Find the binding for an ID, or the empty slot where it would go
+DUI_ChannelBinding * DUI_findChannelBinding(uint32_t id)
+{
+    uint32_t index = (id * 0x9E3779B1u) & (DUI_CHANNEL_MAX_BINDINGS - 1);
+
+    for (int i = 0; i < DUI_CHANNEL_MAX_BINDINGS; ++i) {
+        DUI_ChannelBinding * binding = &_duiChannelBindings[index];
+
+        if (!binding->Bound || binding->ID == id) {
+            return binding;
+        }
+
+        index = (index + 1) & (DUI_CHANNEL_MAX_BINDINGS - 1);
+    }
+
+    return NULL;
+}
+
+// Collect the values published by each thread since the last call
+void DUI_drainChannel()
+{
+    int queueCount = SDL_min(SDL_AtomicGet(&_duiChannelQueueCount), DUI_CHANNEL_MAX_THREADS);
+
+    for (int i = 0; i < queueCount; ++i) {
+        DUI_ChannelQueue * queue = &_duiChannelQueues[i];
+
+        uint32_t head = (uint32_t)SDL_AtomicGet(&queue->Head);
+        uint32_t tail = (uint32_t)SDL_AtomicGet(&queue->Tail);
+        if (head == tail) {
+            continue;
+        }
+
+        // Consecutive values usually have the same ID
+        DUI_ChannelBinding * binding = NULL;
+
+        for (; tail != head; ++tail) {
+            const DUI_ChannelRecord * record = &queue->Records[tail & (DUI_CHANNEL_QUEUE_SIZE - 1)];
+
+            if (!binding || binding->ID != record->ID) {
+                binding = DUI_findChannelBinding(record->ID);
+                if (binding && !binding->Bound) {
+                    binding = NULL;
+                    continue;
+                }
+            }
+
+            if (binding) {
+                binding->HasValue = true;
+                binding->Value = record->Value;
+                binding->Timestamp = record->Timestamp;
+
+                if (binding->Series) {
+                    DUI_SeriesAppend(binding->Series, record->Value);
+                }
+            }
+        }
+
+        // Let the thread reuse the records that were read
+        SDL_AtomicSet(&queue->Tail, (int)head);
+    }
+}
+
+void DUI_resize(int width, int height)
+{
+    _duiWindowWidth = width;
+    _duiWindowHeight = height;
+    _duiPanelStack[0].Bounds = (SDL_Rect){ 0, 0, _duiWindowWidth, _duiWindowHeight };
+
+    // Pooled targets are sized to their panels, and the retained texture
+    //   is reallocated by DUI_renderRetained only if it no longer fits
+    _duiRetainedValid = false;
+}
+
+int DUI_eventWatch(void * userdata, SDL_Event * event)
+{
+    (void)userdata;
+
+    if (event->type == SDL_WINDOWEVENT 
+        && event->window.windowID == (Uint32)_duiWindowID
+        && event->window.event == SDL_WINDOWEVENT_SIZE_CHANGED) {
+        uint32_t width = (uint32_t)SDL_min(SDL_max(event->window.data1, 0), 0x7FFF);
+        uint32_t height = (uint32_t)SDL_min(SDL_max(event->window.data2, 0), 0xFFFF);
+        SDL_AtomicSet(&_duiResizePending, (int)(DUI_RESIZE_PENDING | (width << 16) | height));
+    }
+
+    if (event->type == SDL_MOUSEWHEEL
+        && event->wheel.windowID == (Uint32)_duiWindowID) {
+        int y = event->wheel.y;
+        if (event->wheel.direction == SDL_MOUSEWHEEL_FLIPPED) {
+            y = -y;
+        }
+
+        SDL_AtomicAdd(&_duiWheelPending, y);
+    }
+
+#if defined(DUI_PROFILE_DUMP_KEY)
+    if (event->type == SDL_KEYDOWN 
+        && !event->key.repeat
+        && event->key.keysym.scancode == DUI_PROFILE_DUMP_KEY) {
+        SDL_AtomicSet(&_duiProfileDumpPending, 1);
+    }
+#endif
+
+    return 1;
+}
+
+// Scratch space for the values passed to DUI_drawPlot
+float * _duiPlotValues = NULL;
+size_t _duiPlotValueCapacity = 0;
+
+// Scratch space for the buckets queried by DUI_PlotSeries
+DUI_SeriesBucket * _duiPlotBuckets = NULL;
+size_t _duiPlotBucketCapacity = 0;
+
+// Scratch space for DUI_Histogram, DUI_HISTOGRAM_LANES counts for each bucket
+uint32_t * _duiHistogramCounts = NULL;
+size_t _duiHistogramCountCapacity = 0;
+
+// Scratch space for DUI_FlameGraph
+int * _duiFlameLinks = NULL;
+size_t _duiFlameLinkCapacity = 0;
+
+typedef struct
+{
+    int Node;
+    int Depth;
+    double X;
+
+} DUI_FlameVisit;
+
+DUI_FlameVisit * _duiFlameStack = NULL;
+size_t _duiFlameStackCapacity = 0;
+
+void DUI_Init(SDL_Window * window)
+{
+    _duiWindow = window;
+    _duiRenderer = SDL_GetRenderer(window);
+    _duiWindowID = SDL_GetWindowID(window);
+
+    SDL_SetRenderDrawBlendMode(_duiRenderer, SDL_BLENDMODE_BLEND);
+
+    SDL_GetWindowSize(window, &_duiWindowWidth, &_duiWindowHeight);
+
+    // The Window's Rendering Target
+    _duiPanelStack[0].Fixed = true;
+    _duiPanelStack[0].Bounds = (SDL_Rect){ 0, 0, _duiWindowWidth, _duiWindowHeight };
+    _duiPanelStack[0].Title = NULL;
+
+    // Panel render targets are created on demand by DUI_acquireTarget
+
+    SDL_AtomicSet(&_duiResizePending, 0);
+    SDL_AddEventWatch(DUI_eventWatch, NULL);
+
+    SDL_RWops * fontMem = SDL_RWFromConstMem(DUI_FONT_BMP, sizeof(DUI_FONT_BMP));
+    SDL_Surface * fontSurface = SDL_LoadBMP_RW(fontMem, 1);
+
+    _duiFontTexture = SDL_CreateTextureFromSurface(_duiRenderer, fontSurface);
+    SDL_FreeSurface(fontSurface);
+
+    DUI_buildGlyphTable();
+}
+
+void DUI_Term()
+{
+    SDL_DelEventWatch(DUI_eventWatch, NULL);
+
+#if defined(DUI_TRUETYPE)
+    DUI_writeFontCache();
+    DUI_freeFont();
+#endif
+
+    SDL_DestroyTexture(_duiFontTexture);
+
+    DUI_freeGlyphPages();
+
+    for (size_t i = 0; i < _duiGlyphTextureCount; ++i) {
+        SDL_DestroyTexture(_duiGlyphTextures[i]);
+    }
+
+    SDL_free(_duiGlyphTextures);
+    _duiGlyphTextures = NULL;
+    _duiGlyphTextureCount = 0;
+    _duiGlyphTextureCapacity = 0;
+
+    SDL_free(_duiUserGlyphs);
+    _duiUserGlyphs = NULL;
+    _duiUserGlyphCount = 0;
+    _duiUserGlyphCapacity = 0;
+
+    for (int i = 0; i < DUI_GLYPH_PAGE_COUNT; ++i) {
+        SDL_free(_duiUserGlyphPages[i]);
+        _duiUserGlyphPages[i] = NULL;
+    }
+
+    SDL_free(_duiDrawList.Commands);
+    SDL_free(_duiDrawList.Text);
+    SDL_free(_duiDrawList.Points);
+    SDL_free(_duiDrawList.Sorted);
+    _duiDrawList = (DUI_DrawList){ 0 };
+
+    SDL_free(_duiGlyphBatch.Vertices);
+    SDL_free(_duiGlyphBatch.Indices);
+    _duiGlyphBatch = (DUI_GlyphBatch){ 0 };
+
+    for (int i = 0; i < DUI_TARGET_POOL_SIZE; ++i) {
+        SDL_DestroyTexture(_duiTargetPool[i].Texture);
+        _duiTargetPool[i] = (DUI_PooledTarget){ .Texture = NULL };
+    }
+
+    SDL_DestroyTexture(_duiOverlayTexture);
+    _duiOverlayTexture = NULL;
+
+    // Let a dump in progress finish writing its file
+    if (_duiProfileDumpThread) {
+        SDL_WaitThread(_duiProfileDumpThread, NULL);
+        _duiProfileDumpThread = NULL;
+    }
+
+    if (_duiProfileDump) {
+        SDL_free(_duiProfileDump->Events);
+        SDL_free(_duiProfileDump);
+        _duiProfileDump = NULL;
+    }
+
+    // Bound series may be destroyed after this
+    SDL_memset(_duiChannelBindings, 0, sizeof(_duiChannelBindings));
+    _duiChannelBindingCount = 0;
+
+    SDL_DestroyTexture(_duiRetainedTexture);
+    _duiRetainedTexture = NULL;
+    _duiRetainedWidth = 0;
+    _duiRetainedHeight = 0;
+    _duiRetainedTextureWidth = 0;
+    _duiRetainedTextureHeight = 0;
+    _duiRetainedValid = false;
+
+    for (int i = 0; i < 2; ++i) {
+        SDL_free(_duiRetainedItems[i]);
+        _duiRetainedItems[i] = NULL;
+        _duiRetainedItemCount[i] = 0;
+        _duiRetainedItemCapacity[i] = 0;
+    }
+
+    SDL_free(_duiRetainedSlots);
+    _duiRetainedSlots = NULL;
+    _duiRetainedSlotCapacity = 0;
+
+    DUI_destroyTextCachePages(0);
+    SDL_memset(_duiTextCache, 0, sizeof(_duiTextCache));
+
+    SDL_free(_duiTextCacheLookups);
+    _duiTextCacheLookups = NULL;
+    _duiTextCacheLookupCapacity = 0;
+    _duiTextCacheCommands = NULL;
+
+    SDL_free(_duiPlotValues);
+    _duiPlotValues = NULL;
+    _duiPlotValueCapacity = 0;
+
+    SDL_free(_duiPlotBuckets);
+    _duiPlotBuckets = NULL;
+    _duiPlotBucketCapacity = 0;
+
+    SDL_free(_duiHistogramCounts);
+    _duiHistogramCounts = NULL;
+    _duiHistogramCountCapacity = 0;
+
+    SDL_free(_duiFlameLinks);
+    _duiFlameLinks = NULL;
+    _duiFlameLinkCapacity = 0;
+
+    SDL_free(_duiFlameStack);
+    _duiFlameStack = NULL;
+    _duiFlameStackCapacity = 0;
+}
+
+void DUI_Update()
+{
+    _duiProfileFrames[_duiProfileFrameCount % DUI_PROFILE_MAX_FRAMES] = SDL_GetPerformanceCounter();
+    ++_duiProfileFrameCount;
+
+    uint32_t resize = (uint32_t)SDL_AtomicSet(&_duiResizePending, 0);
+    if (resize & DUI_RESIZE_PENDING) {
+        DUI_resize((int)((resize >> 16) & 0x7FFF), (int)(resize & 0xFFFF));
+    }
+
+    DUI_drainChannel();
+
+    if (SDL_AtomicSet(&_duiProfileDumpPending, 0)) {
+        DUI_ProfilerDump(DUI_PROFILE_DUMP_PATH);
+    }
+
+    int state = SDL_GetMouseState(&_duiMouse.x, &_duiMouse.y);
+    bool pressed = (state & SDL_BUTTON(SDL_BUTTON_LEFT));
+    _duiClicked = (pressed && !_duiMouseDown);
+    _duiMouseDown = pressed;
+
+    _duiWheel = SDL_AtomicSet(&_duiWheelPending, 0);
+
+#if defined(DUI_TRUETYPE)
+    // Keep the edges of distance field glyphs sharp at the size they're drawn
+    if (_duiFont.Spread > 0) {
+        DUI_selectFontRamp(_duiStyle.CharHeight);
+    }
+#endif
+}
+
+typedef struct
+{
+    // The pooled target being drawn to, or NULL if drawing to the parent's texture
+    DUI_PooledTarget * Target;
+
+    SDL_Texture * Texture;
+
+    // The position of the top-left corner of Texture in the window
+    SDL_Point Origin;
+
+    // The clip rect, relative to Texture
+    bool HasClip;
+    SDL_Rect Clip;
+
+} DUI_ReplayLevel;
+
+void DUI_applyClip(const DUI_ReplayLevel * level)
+{
+    DUI_setRenderClip(level->HasClip ? &level->Clip : NULL);
+}
+
+// Move *index from a DUI_COMMAND_PANEL_BEGIN to its DUI_COMMAND_PANEL_END
+void DUI_skipPanel(const DUI_DrawCommand * commands, size_t count, size_t * index)
+{
+    int skip = 1;
+    while (skip > 0 && ++*index < count) {
+        if (commands[*index].Type == DUI_COMMAND_PANEL_BEGIN) {
+            ++skip;
+        }
+        else if (commands[*index].Type == DUI_COMMAND_PANEL_END) {
+            --skip;
+        }
+    }
+}
+
+void DUI_replay(const DUI_DrawCommand * commands, size_t count, const SDL_Rect * cull)
+{
+    DUI_ReplayLevel stack[DUI_PANEL_STACK_DEPTH + 1];
+    int depth = 0;
+
+    if (_duiTextCacheFrame != _duiFrame || _duiTextCacheCommands != commands) {
+        DUI_prepareTextCache(commands, count);
+    }
+
+    stack[0] = (DUI_ReplayLevel){
+        .Target = NULL,
+        .Texture = _duiRenderState.Target,
+        .Origin = { 0, 0 },
+        .HasClip = _duiRenderState.HasClip,
+        .Clip = _duiRenderState.Clip,
+    };
+
+    for (size_t i = 0; i < count; ++i) {
+        const DUI_DrawCommand * command = &commands[i];
+        DUI_ReplayLevel * level = &stack[depth];
+
+        if (cull && !SDL_HasIntersection(&command->Bounds, cull)) {
+            if (command->Type == DUI_COMMAND_PANEL_BEGIN) {
+                // Skip the panel and all of its contents
+                DUI_skipPanel(commands, count, &i);
+                continue;
+            }
+
+            if (command->Type != DUI_COMMAND_PANEL_END) {
+                continue;
+            }
+        }
+
+        // Rects and text are batched until a panel changes the target or clip,
+        //   or something else is drawn
+        if (command->Type != DUI_COMMAND_FILL_RECT 
+            && command->Type != DUI_COMMAND_DRAW_RECT 
+            && command->Type != DUI_COMMAND_TEXT) {
+            DUI_flushGlyphs();
+        }
+
+        SDL_Rect bounds = command->Bounds;
+        bounds.x -= level->Origin.x;
+        bounds.y -= level->Origin.y;
+
+        switch (command->Type) {
+        case DUI_COMMAND_FILL_RECT:
+            DUI_pushRect(&bounds, command->Color, false);
+            break;
+        case DUI_COMMAND_DRAW_RECT:
+            DUI_pushRect(&bounds, command->Color, true);
+            break;
+        case DUI_COMMAND_TEXT:
+            DUI_pushTextBounds(&bounds);
+            DUI_renderText(command, &bounds);
+            break;
+        case DUI_COMMAND_LINES: {
+            SDL_Point * points = _duiDrawList.Points + command->Offset;
+
+            if (level->Origin.x != 0 || level->Origin.y != 0) {
+                for (uint32_t j = 0; j < command->Length; ++j) {
+                    points[j].x -= level->Origin.x;
+                    points[j].y -= level->Origin.y;
+                }
+            }
+
+            DUI_setRenderDrawColor(
+                command->Color[0],
+                command->Color[1],
+                command->Color[2],
+                command->Color[3]);
+            ++_duiStatsFrame.LineCalls;
+            SDL_RenderDrawLines(_duiRenderer, points, command->Length);
+
+            if (level->Origin.x != 0 || level->Origin.y != 0) {
+                for (uint32_t j = 0; j < command->Length; ++j) {
+                    points[j].x += level->Origin.x;
+                    points[j].y += level->Origin.y;
+                }
+            }
+            break;
+        }
+        case DUI_COMMAND_PANEL_BEGIN: {
+            DUI_ReplayLevel * panel = &stack[++depth];
+            *panel = *level;
+            panel->Target = NULL;
+
+            if (command->PanelFlags & DUI_PANEL_OFFSCREEN) {
+                panel->Target = DUI_acquireTarget(bounds.w, bounds.h);
+            }
+
+            if (panel->Target) {
+                panel->Texture = panel->Target->Texture;
+                panel->Origin = (SDL_Point){ command->Bounds.x, command->Bounds.y };
+                panel->HasClip = false;
+
+                DUI_setRenderTarget(panel->Texture);
+                DUI_setRenderDrawColor(0x00, 0x00, 0x00, 0x00);
+                SDL_RenderClear(_duiRenderer);
+            }
+            else {
+                bool visible = !SDL_RectEmpty(&bounds);
+
+                if (visible && panel->HasClip) {
+                    visible = SDL_IntersectRect(&panel->Clip, &bounds, &panel->Clip);
+                }
+                else {
+                    panel->Clip = bounds;
+                    panel->HasClip = true;
+                }
+
+                // An empty clip rect would disable clipping, so nothing in
+                //   a panel outside of its parent's clip is drawn instead
+                if (!visible) {
+                    --depth;
+                    DUI_skipPanel(commands, count, &i);
+                    break;
+                }
+
+                DUI_applyClip(panel);
+            }
+            break;
+        }
+        case DUI_COMMAND_PANEL_END: {
+            DUI_ReplayLevel * panel = &stack[depth--];
+
+            if (panel->Target) {
+                SDL_Rect src = { 0, 0, bounds.w, bounds.h };
+
+                SDL_Rect dst = command->Bounds;
+                dst.x -= stack[depth].Origin.x;
+                dst.y -= stack[depth].Origin.y;
+
+                DUI_setRenderTarget(stack[depth].Texture);
+                ++_duiStatsFrame.CopyCalls;
+                SDL_RenderCopy(_duiRenderer, panel->Texture, &src, &dst);
+
+                DUI_releaseTarget(panel->Target);
+            }
+
+            DUI_applyClip(&stack[depth]);
+            break;
+        }
+        }
+    }
+
+    DUI_flushGlyphs();
+}
+
+uint64_t DUI_hashFrame(const DUI_DrawCommand * commands, size_t count)
+{
+    DUI_DrawList * list = &_duiDrawList;
+
+    uint64_t hash = DUI_hash(&_duiRetainedWidth, sizeof(_duiRetainedWidth), 0);
+    hash = DUI_hash(&_duiRetainedHeight, sizeof(_duiRetainedHeight), hash);
+    hash = DUI_hash(commands, count * sizeof(DUI_DrawCommand), hash);
+    hash = DUI_hash(list->Text, list->TextLength, hash);
+    hash = DUI_hash(list->Points, list->PointCount * sizeof(SDL_Point), hash);
+    return hash;
+}
+
+DUI_RetainedSlot * DUI_findRetainedSlot(uint64_t hash)
+{
+    size_t mask = _duiRetainedSlotCapacity - 1;
+    size_t index = hash & mask;
+
+    while (_duiRetainedSlots[index].Hash != 0 && _duiRetainedSlots[index].Hash != hash) {
+        index = (index + 1) & mask;
+    }
+
+    return &_duiRetainedSlots[index];
+}
+
+void DUI_addDirtyRect(const SDL_Rect * bounds)
+{
+    if (SDL_RectEmpty(bounds)) {
+        return;
+    }
+
+    // Absorb any rectangles this touches, so they are not drawn twice
+    SDL_Rect rect = *bounds;
+    for (int i = 0; i < _duiDirtyRectCount; ++i) {
+        if (SDL_HasIntersection(&rect, &_duiDirtyRects[i])) {
+            SDL_UnionRect(&rect, &_duiDirtyRects[i], &rect);
+            _duiDirtyRects[i] = _duiDirtyRects[--_duiDirtyRectCount];
+            i = -1;
+        }
+    }
+
+    if (_duiDirtyRectCount < _duiMaxDirtyRects) {
+        _duiDirtyRects[_duiDirtyRectCount++] = rect;
+        return;
+    }
+
+    // Out of rectangles, merge with whichever one grows the least
+    int best = 0;
+    int bestGrowth = INT32_MAX;
+    for (int i = 0; i < _duiDirtyRectCount; ++i) {
+        SDL_Rect merged;
+        SDL_UnionRect(&rect, &_duiDirtyRects[i], &merged);
+
+        int growth = (merged.w * merged.h) - (_duiDirtyRects[i].w * _duiDirtyRects[i].h);
+        if (growth < bestGrowth) {
+            best = i;
+            bestGrowth = growth;
+        }
+    }
+
+    SDL_UnionRect(&rect, &_duiDirtyRects[best], &rect);
+    _duiDirtyRects[best] = _duiDirtyRects[--_duiDirtyRectCount];
+    DUI_addDirtyRect(&rect);
+}
+
+// Compare each command with the items drawn into the retained texture,
+//   and fill _duiDirtyRects with the areas that need to be drawn again
+bool DUI_findDirtyRects(const DUI_DrawCommand * commands, size_t count)
+{
+    DUI_DrawList * list = &_duiDrawList;
+
+    DUI_RetainedItem * previous = _duiRetainedItems[0];
+    size_t previousCount = _duiRetainedItemCount[0];
+
+    if (!DUI_reserve((void **)&_duiRetainedItems[1], &_duiRetainedItemCapacity[1],
+            count, sizeof(DUI_RetainedItem))) {
+        return false;
+    }
+
+    DUI_RetainedItem * current = _duiRetainedItems[1];
+    _duiRetainedItemCount[1] = count;
+
+    for (size_t i = 0; i < count; ++i) {
+        // The offset into the text changes whenever earlier text does
+        DUI_DrawCommand command = commands[i];
+        command.Offset = 0;
+
+        uint64_t hash = DUI_hash(&command, sizeof(command), 0);
+        if (command.Type == DUI_COMMAND_TEXT) {
+            hash = DUI_hash(list->Text + commands[i].Offset, command.Length, hash);
+        }
+        else if (command.Type == DUI_COMMAND_LINES) {
+            hash = DUI_hash(list->Points + commands[i].Offset, 
+                command.Length * sizeof(SDL_Point), hash);
+        }
+
+        current[i].Hash = (hash != 0 ? hash : 1);
+        current[i].Bounds = command.Bounds;
+    }
+
+    size_t slots = 16;
+    while (slots < (count + previousCount) * 2) {
+        slots *= 2;
+    }
+
+    if (slots > _duiRetainedSlotCapacity) {
+        DUI_RetainedSlot * newSlots = SDL_realloc(_duiRetainedSlots, slots * sizeof(DUI_RetainedSlot));
+        if (!newSlots) {
+            return false;
+        }
+
+        _duiRetainedSlots = newSlots;
+        _duiRetainedSlotCapacity = slots;
+    }
+
+    SDL_memset(_duiRetainedSlots, 0, _duiRetainedSlotCapacity * sizeof(DUI_RetainedSlot));
+
+    // Walk backwards, so each slot lists its items in the order they were drawn
+    for (size_t i = previousCount; i-- > 0;) {
+        DUI_RetainedSlot * slot = DUI_findRetainedSlot(previous[i].Hash);
+        slot->Hash = previous[i].Hash;
+        previous[i].Next = slot->First;
+        slot->First = i;
+        ++slot->Count;
+    }
+
+    _duiDirtyRectCount = 0;
+
+    // One past the latest previous item matched so far
+    size_t latest = 0;
+
+    // Anything new this frame needs to be drawn
+    for (size_t i = 0; i < count; ++i) {
+        DUI_RetainedSlot * slot = DUI_findRetainedSlot(current[i].Hash);
+        if (slot->Count > 0) {
+            size_t match = slot->First;
+            slot->First = previous[match].Next;
+            --slot->Count;
+
+            // An item now drawn before something it was drawn after may 
+            //   overlap it the other way around, so it's drawn again
+            if (match < latest) {
+                DUI_addDirtyRect(&current[i].Bounds);
+            }
+            else {
+                latest = match + 1;
+            }
+        }
+        else {
+            DUI_addDirtyRect(&current[i].Bounds);
+        }
+    }
+
+    // Anything left over from the previous frame needs to be erased
+    for (size_t i = 0; i < previousCount; ++i) {
+        DUI_RetainedSlot * slot = DUI_findRetainedSlot(previous[i].Hash);
+        if (slot->Count > 0) {
+            --slot->Count;
+            DUI_addDirtyRect(&previous[i].Bounds);
+        }
+    }
+
+    // Swap, so the current items become the previous items
+    _duiRetainedItems[1] = _duiRetainedItems[0];
+    _duiRetainedItems[0] = current;
+
+    _duiRetainedItemCount[1] = _duiRetainedItemCount[0];
+    _duiRetainedItemCount[0] = count;
+
+    size_t capacity = _duiRetainedItemCapacity[1];
+    _duiRetainedItemCapacity[1] = _duiRetainedItemCapacity[0];
+    _duiRetainedItemCapacity[0] = capacity;
+
+    return true;
+}
+
+void DUI_renderRetained(const DUI_DrawCommand * commands, size_t count)
+{
+    if (_duiRetainedWidth != _duiWindowWidth || _duiRetainedHeight != _duiWindowHeight) {
+        _duiRetainedWidth = _duiWindowWidth;
+        _duiRetainedHeight = _duiWindowHeight;
+        _duiRetainedValid = false;
+
+        // Keep the texture while the window fits, unless it is less than 
+        //   half the size, so that resizing the window rarely reallocates it
+        bool grow = (_duiRetainedWidth > _duiRetainedTextureWidth 
+            || _duiRetainedHeight > _duiRetainedTextureHeight);
+        bool shrink = (_duiRetainedWidth * 2 < _duiRetainedTextureWidth 
+            && _duiRetainedHeight * 2 < _duiRetainedTextureHeight);
+
+        if (!_duiRetainedTexture || grow || shrink) {
+            SDL_DestroyTexture(_duiRetainedTexture);
+
+            _duiRetainedTextureWidth = DUI_targetSize(_duiRetainedWidth);
+            _duiRetainedTextureHeight = DUI_targetSize(_duiRetainedHeight);
+            _duiRetainedTexture = SDL_CreateTexture(_duiRenderer, 
+                SDL_PIXELFORMAT_RGBA32,
+                SDL_TEXTUREACCESS_TARGET,
+                _duiRetainedTextureWidth, _duiRetainedTextureHeight);
+
+            if (!_duiRetainedTexture) {
+                _duiRetainedWidth = 0;
+                _duiRetainedHeight = 0;
+                _duiRetainedTextureWidth = 0;
+                _duiRetainedTextureHeight = 0;
+                DUI_replay(commands, count, NULL);
+                return;
+            }
+
+            DUI_setTargetBlendMode(_duiRetainedTexture);
+        }
+    }
+
+    // Input only changes what is drawn through the commands it produces, such
+    //   as a hover color, so the commands are all that need to be compared
+    uint64_t hash = DUI_hashFrame(commands, count);
+
+    if (_duiRetainedValid && hash == _duiRetainedHash) {
+        ++_duiRetainedStats.Hits;
+    }
+    else {
+        ++_duiRetainedStats.Misses;
+        _duiRetainedHash = hash;
+
+        bool partial = DUI_findDirtyRects(commands, count) 
+            && _duiRetainedValid 
+            && _duiMaxDirtyRects > 0;
+
+        SDL_Texture * target = _duiRenderState.Target;
+        DUI_setRenderTarget(_duiRetainedTexture);
+
+        if (partial) {
+            for (int i = 0; i < _duiDirtyRectCount; ++i) {
+                SDL_Rect * dirty = &_duiDirtyRects[i];
+
+                DUI_setRenderClip(dirty);
+
+                DUI_setRenderDrawColor(0x00, 0x00, 0x00, 0x00);
+                DUI_setRenderDrawBlendMode(SDL_BLENDMODE_NONE);
+                SDL_RenderFillRect(_duiRenderer, dirty);
+                DUI_setRenderDrawBlendMode(SDL_BLENDMODE_BLEND);
+
+                DUI_replay(commands, count, dirty);
+            }
+
+            DUI_setRenderClip(NULL);
+        }
+        else {
+            DUI_setRenderDrawColor(0x00, 0x00, 0x00, 0x00);
+            SDL_RenderClear(_duiRenderer);
+            DUI_replay(commands, count, NULL);
+        }
+
+        DUI_setRenderTarget(target);
+        _duiRetainedValid = true;
+    }
+
+    SDL_Rect bounds = { 0, 0, _duiRetainedWidth, _duiRetainedHeight };
+    ++_duiStatsFrame.CopyCalls;
+    SDL_RenderCopy(_duiRenderer, _duiRetainedTexture, &bounds, &bounds);
+}
+
+void DUI_renderPerfHUD(uint64_t now)
+{
+    int lineHeight = _duiStyle.CharHeight + _duiStyle.LinePadding;
+
+    SDL_Rect bounds = {
+        .x = 0,
+        .y = 0,
+        .w = (DUI_PERF_HUD_COLUMNS * _duiStyle.CharWidth) + (_duiStyle.PanelPadding * 2),
+        .h = ((DUI_PERF_HUD_LINES + DUI_PERF_HUD_GRAPH_LINES) * lineHeight)
+            + (_duiStyle.PanelPadding * 2) - _duiStyle.LinePadding,
+    };
+
+    bool update = (now - _duiPerfHUDUpdated >= _duiPerfHUDInterval);
+
+    if (!_duiOverlayTexture) {
+        _duiOverlayTexture = SDL_CreateTexture(_duiRenderer, 
+            SDL_PIXELFORMAT_RGBA32,
+            SDL_TEXTUREACCESS_TARGET,
+            bounds.w, bounds.h);
+
+        if (!_duiOverlayTexture) {
+            return;
+        }
+
+        DUI_setTargetBlendMode(_duiOverlayTexture);
+        update = true;
+    }
+
+    if (update) {
+        _duiPerfHUDUpdated = now;
+
+        const DUI_Stats * stats = &_duiStats;
+        double msPerTick = 1000.0 / SDL_GetPerformanceFrequency();
+
+        // Frame times, oldest first
+        float frameTimes[DUI_PERF_HUD_SAMPLES];
+        int sampleCount = (int)SDL_min(_duiPerfHUDFrameCount, DUI_PERF_HUD_SAMPLES) - 1;
+        float maximum = 0.0f;
+
+        for (int i = 0; i < sampleCount; ++i) {
+            uint32_t index = _duiPerfHUDFrameCount - sampleCount + i;
+            uint64_t time = _duiPerfHUDFrames[index % DUI_PERF_HUD_SAMPLES] 
+                - _duiPerfHUDFrames[(index - 1) % DUI_PERF_HUD_SAMPLES];
+
+            frameTimes[i] = (float)(time * msPerTick);
+            maximum = SDL_max(maximum, frameTimes[i]);
+        }
+
+        double average = 0.0;
+        if (sampleCount > 0) {
+            uint64_t newest = _duiPerfHUDFrames[(_duiPerfHUDFrameCount - 1) % DUI_PERF_HUD_SAMPLES];
+            uint64_t oldest = _duiPerfHUDFrames[(_duiPerfHUDFrameCount - 1 - sampleCount) % DUI_PERF_HUD_SAMPLES];
+            average = ((newest - oldest) * msPerTick) / sampleCount;
+        }
+
+        uint32_t drawCalls = stats->FillCalls + stats->OutlineCalls + stats->LineCalls 
+            + stats->CopyCalls + stats->GeometryCalls;
+
+        char lines[DUI_PERF_HUD_LINES][DUI_PERF_HUD_COLUMNS + 1];
+        snprintf(lines[0], sizeof(lines[0]), "FPS %.1f, FRAME %.2f MS, MAX %.2f", 
+            (average > 0.0 ? 1000.0 / average : 0.0), average, maximum);
+        snprintf(lines[1], sizeof(lines[1]), "DUI %.2f MS, RENDER %.2f, PRINT %.2f", 
+            stats->RenderTime + stats->PrintTime, stats->RenderTime, stats->PrintTime);
+        snprintf(lines[2], sizeof(lines[2]), "DRAW CALLS %u, TARGETS %u", 
+            drawCalls, stats->TargetSwitches);
+        snprintf(lines[3], sizeof(lines[3]), "FILLS %u, OUTLINES %u, LINES %u", 
+            stats->FillCalls, stats->OutlineCalls, stats->LineCalls);
+        snprintf(lines[4], sizeof(lines[4]), "COPIES %u, GEOMETRY %u, GLYPHS %u", 
+            stats->CopyCalls, stats->GeometryCalls, stats->Glyphs);
+        snprintf(lines[5], sizeof(lines[5]), "WIDGETS %u, PANELS %u, COMMANDS %u", 
+            stats->Widgets, stats->Panels, stats->Commands);
+
+        DUI_RenderState saved = _duiRenderState;
+
+        DUI_setRenderTarget(_duiOverlayTexture);
+        DUI_setRenderClip(NULL);
+        DUI_setRenderDrawColor(0x00, 0x00, 0x00, 0xC0);
+        SDL_RenderClear(_duiRenderer);
+
+        SDL_Rect line = {
+            .x = _duiStyle.PanelPadding,
+            .y = _duiStyle.PanelPadding,
+            .w = 0,
+            .h = _duiStyle.CharHeight,
+        };
+
+        DUI_drawGlyphs((const unsigned char *)lines[0], strlen(lines[0]), &line, 
+            _duiStyle.CharWidth, DUI_TEXT_COLOR);
+        line.y += lineHeight;
+
+        // One bar per frame, scaled to the longest frame
+        SDL_Rect graph = {
+            .x = line.x,
+            .y = line.y,
+            .w = DUI_PERF_HUD_COLUMNS * _duiStyle.CharWidth,
+            .h = (DUI_PERF_HUD_GRAPH_LINES * lineHeight) - _duiStyle.LinePadding,
+        };
+
+        SDL_Rect bars[DUI_PERF_HUD_SAMPLES];
+        int barCount = 0;
+
+        for (int i = 0; i < sampleCount && maximum > 0.0f; ++i) {
+            int x0 = graph.x + ((i * graph.w) / DUI_PERF_HUD_SAMPLES);
+            int x1 = graph.x + (((i + 1) * graph.w) / DUI_PERF_HUD_SAMPLES);
+            int h = SDL_max((int)((frameTimes[i] / maximum) * graph.h), 1);
+
+            bars[barCount++] = (SDL_Rect){ x0, graph.y + graph.h - h, SDL_max(x1 - x0 - 1, 1), h };
+        }
+
+        if (barCount > 0) {
+            DUI_setRenderDrawColor(DUI_TEXT_COLOR[0], DUI_TEXT_COLOR[1], DUI_TEXT_COLOR[2], 0x80);
+            SDL_RenderFillRects(_duiRenderer, bars, barCount);
+        }
+
+        line.y += DUI_PERF_HUD_GRAPH_LINES * lineHeight;
+
+        for (int i = 1; i < DUI_PERF_HUD_LINES; ++i) {
+            DUI_drawGlyphs((const unsigned char *)lines[i], strlen(lines[i]), &line, 
+                _duiStyle.CharWidth, DUI_TEXT_COLOR);
+            line.y += lineHeight;
+        }
+
+        DUI_flushGlyphs();
+
+        DUI_setRenderTarget(saved.Target);
+        DUI_setRenderClip(saved.HasClip ? &saved.Clip : NULL);
+    }
+
+    SDL_Rect dst = bounds;
+    dst.x = _duiWindowWidth - bounds.w;
+
+    SDL_RenderCopy(_duiRenderer, _duiOverlayTexture, &bounds, &dst);
+}
+
+void DUI_Render()
+{
+    uint64_t start = SDL_GetPerformanceCounter();
+
+    DUI_DrawList * list = &_duiDrawList;
+    DUI_DrawCommand * commands = DUI_sortCommands();
+
+    _duiStatsFrame.Commands = list->CommandCount;
+
+    DUI_syncRenderState();
+    DUI_setRenderDrawBlendMode(SDL_BLENDMODE_BLEND);
+
+    if (_duiRetained) {
+        DUI_renderRetained(commands, list->CommandCount);
+    }
+    else {
+        DUI_replay(commands, list->CommandCount, NULL);
+    }
+
+    list->CommandCount = 0;
+    list->TextLength = 0;
+    list->PointCount = 0;
+    list->Layers = 0;
+
+    DUI_trimTargetPool();
+    ++_duiFrame;
+
+    uint64_t now = SDL_GetPerformanceCounter();
+
+    double msPerTick = 1000.0 / SDL_GetPerformanceFrequency();
+    _duiStatsFrame.PrintTime = _duiPrintTicks * msPerTick;
+    _duiStatsFrame.RenderTime = (now - start) * msPerTick;
+
+    _duiPerfHUDFrames[_duiPerfHUDFrameCount % DUI_PERF_HUD_SAMPLES] = now;
+    ++_duiPerfHUDFrameCount;
+
+    _duiStats = _duiStatsFrame;
+
+    // Drawn after the stats are recorded, and its own counts are discarded
+    if (_duiPerfHUD) {
+        DUI_renderPerfHUD(now);
+    }
+
+    _duiStatsFrame = (DUI_Stats){ 0 };
+    _duiPrintTicks = 0;
+}
+
+DUI_Stats DUI_GetStats()
+{
+    return _duiStats;
+}
+
+void DUI_SetPerfHUD(bool enabled, float updatesPerSecond)
+{
+    _duiPerfHUD = enabled;
+
+    if (updatesPerSecond <= 0.0f) {
+        updatesPerSecond = DUI_PERF_HUD_RATE;
+    }
+
+    _duiPerfHUDInterval = (uint64_t)(SDL_GetPerformanceFrequency() / updatesPerSecond);
+
+    if (!_duiPerfHUD) {
+        SDL_DestroyTexture(_duiOverlayTexture);
+        _duiOverlayTexture = NULL;
+    }
+}
+
+void DUI_SetRetained(bool retained)
+{
+    _duiRetained = retained;
+
+    if (!_duiRetained) {
+        SDL_DestroyTexture(_duiRetainedTexture);
+        _duiRetainedTexture = NULL;
+        _duiRetainedWidth = 0;
+        _duiRetainedHeight = 0;
+        _duiRetainedTextureWidth = 0;
+        _duiRetainedTextureHeight = 0;
+        _duiRetainedValid = false;
+    }
+}
+
+void DUI_SetMaxDirtyRects(int count)
+{
+    _duiMaxDirtyRects = SDL_max(0, SDL_min(count, DUI_MAX_DIRTY_RECTS));
+}
+
+DUI_CacheStats DUI_GetRetainedStats()
+{
+    DUI_CacheStats stats = _duiRetainedStats;
+    stats.Bytes = (size_t)_duiRetainedTextureWidth * _duiRetainedTextureHeight * 4;
+    return stats;
+}
+
+void DUI_SetTextCacheBudget(size_t bytes)
+{
+    _duiTextCacheBudget = bytes;
+
+    int maxPages = SDL_min(DUI_TEXT_CACHE_MAX_PAGES, 
+        (int)(_duiTextCacheBudget / DUI_TEXT_CACHE_PAGE_BYTES));
+    DUI_destroyTextCachePages(maxPages);
+}
+
+DUI_CacheStats DUI_GetTextCacheStats()
+{
+    return _duiTextCacheStats;
+}
+
+DUI_CacheStats DUI_GetRenderStateStats()
+{
+    return _duiRenderStateStats;
+}
+
+void DUI_SetStyle(DUI_Style style)
+{
+    _duiStyle = style;
+}
+
+DUI_Style * DUI_GetStyle()
+{
+    return &_duiStyle;
+}
+
+void DUI_SetColorBackground()
+{
+    DUI_setDrawColor(_duiStyle.ColorBackground);
+}
+
+void DUI_SetColorBorder()
+{
+    DUI_setDrawColor(_duiStyle.ColorBorder);
+}
+
+void DUI_SetColorHover()
+{
+    DUI_setDrawColor(_duiStyle.ColorHover);
+}
+
+void DUI_SetColorDefault()
+{
+    DUI_setDrawColor(_duiStyle.ColorDefault);
+}
+
+void DUI_SetLayer(DUI_Layer layer)
+{
+    _duiLayer = layer;
+}
+
+const DUI_Glyph * DUI_GetGlyph(uint32_t codepoint)
+{
+    return DUI_lookupGlyph(codepoint);
+}
+
+bool DUI_AddGlyph(uint32_t codepoint, SDL_Texture * texture, const SDL_Rect * src)
+{
+    if (codepoint >= 0x110000) {
+        return false;
+    }
+
+    DUI_Glyph glyph = {
+        .Texture = texture,
+        .Src = (texture ? *src : (SDL_Rect){ 0, 0, 0, 0 }),
+    };
+
+    uint32_t ** page = &_duiUserGlyphPages[codepoint / DUI_GLYPH_PAGE_SIZE];
+    if (!*page) {
+        *page = SDL_calloc(DUI_GLYPH_PAGE_SIZE, sizeof(uint32_t));
+        if (!*page) {
+            return false;
+        }
+    }
+
+    // Replace the glyph if it was added before, so it's only set once when
+    //   the font changes
+    uint32_t * slot = &(*page)[codepoint % DUI_GLYPH_PAGE_SIZE];
+
+    if (*slot == 0) {
+        if (!DUI_reserve((void **)&_duiUserGlyphs, &_duiUserGlyphCapacity, 
+                _duiUserGlyphCount + 1, sizeof(DUI_UserGlyph))) {
+            return false;
+        }
+
+        *slot = (uint32_t)++_duiUserGlyphCount;
+    }
+
+    _duiUserGlyphs[*slot - 1] = (DUI_UserGlyph){ codepoint, glyph };
+
+    if (!DUI_setGlyph(codepoint, &glyph)) {
+        return false;
+    }
+
+#if defined(DUI_TRUETYPE)
+    // Don't let the font replace it
+    if (_duiFont.Data) {
+        _duiFont.Baked[codepoint / 32] |= (1u << (codepoint % 32));
+    }
+#endif
+
+    _duiRetainedValid = false;
+    return true;
+}
+
+bool DUI_AddGlyphPage(SDL_Surface * surface, int cellWidth, int cellHeight, 
+    const uint32_t * codepoints, size_t count)
+{
+    if (!surface || cellWidth <= 0 || cellHeight <= 0 || surface->w < cellWidth) {
+        return false;
+    }
+
+    if (!DUI_reserve((void **)&_duiGlyphTextures, &_duiGlyphTextureCapacity, 
+            _duiGlyphTextureCount + 1, sizeof(SDL_Texture *))) {
+        return false;
+    }
+
+    SDL_Texture * texture = SDL_CreateTextureFromSurface(_duiRenderer, surface);
+    if (!texture) {
+        return false;
+    }
+
+    _duiGlyphTextures[_duiGlyphTextureCount++] = texture;
+
+    int columns = surface->w / cellWidth;
+
+    for (size_t i = 0; i < count; ++i) {
+        if (codepoints[i] == 0) {
+            continue;
+        }
+
+        SDL_Rect src = {
+            .x = (int)(i % columns) * cellWidth,
+            .y = (int)(i / columns) * cellHeight,
+            .w = cellWidth,
+            .h = cellHeight,
+        };
+
+        if (src.y + src.h > surface->h) {
+            break;
+        }
+
+        if (!DUI_AddGlyph(codepoints[i], texture, &src)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void DUI_MoveCursor(int x, int y)
+{
+    _duiCursor.x = x;
+    _duiCursor.y = y;
+    _duiLineStart = _duiCursor.x;
+}
+
+void DUI_MoveCursorRelative(int dx, int dy)
+{
+    _duiCursor.x += dx;
+    _duiCursor.y += dy;
+    _duiLineStart = _duiCursor.x;
+}
+
+void DUI_GetCursor(int * x, int * y)
+{
+    *x = _duiCursor.x;
+    *y = _duiCursor.y;
+}
+
+void DUI_Newline()
+{
+    _duiCursor.y += _duiStyle.CharHeight + _duiStyle.LinePadding;
+    _duiCursor.x = _duiLineStart;
+
+    DUI_growPanel();
+}
+
+// Measure the lines of text. There is no cache, as hashing the text to
+//   look it up would cost about as much as this pass
+void DUI_measureText(const char * text, size_t length, int * width, int * height)
+{
+    size_t lines = 1;
+    size_t longest = 0;
+
+    for (;;) {
+        const char * newline = memchr(text, '\n', length);
+        size_t lineLength = (newline ? (size_t)(newline - text) : length);
+
+        longest = SDL_max(longest, DUI_countCharacters(text, lineLength));
+
+        if (!newline) {
+            break;
+        }
+
+        ++lines;
+        length -= lineLength + 1;
+        text = newline + 1;
+    }
+
+    *width = (int)longest * _duiStyle.CharWidth;
+    *height = ((int)lines * (_duiStyle.CharHeight + _duiStyle.LinePadding)) - _duiStyle.LinePadding;
+}
+
+void DUI_MeasureText(const char * text, int * width, int * height)
+{
+    int w, h;
+    DUI_measureText(text, strlen(text), &w, &h);
+
+    if (width) {
+        *width = w;
+    }
+
+    if (height) {
+        *height = h;
+    }
+}
+
+const char * DUI_MeasureTextf(int * width, int * height, const char * format, ...)
+{
+    static char buffer[1024];
+
+    uint64_t start = SDL_GetPerformanceCounter();
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+
+    DUI_MeasureText(buffer, width, height);
+
+    _duiPrintTicks += SDL_GetPerformanceCounter() - start;
+
+    return buffer;
+}
+
+// Print a widget's label, keeping every line of it at the current x
+void DUI_printLabel(const char * text)
+{
+    int lineStart = _duiLineStart;
+    _duiLineStart = _duiCursor.x;
+
+    DUI_printText(text, strlen(text));
+
+    _duiLineStart = lineStart;
+}
+
+void DUI_Print(const char * format, ...)
+{
+    static char buffer[1024];
+
+    uint64_t start = SDL_GetPerformanceCounter();
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+
+    size_t length = strlen(buffer);
+    _duiStatsFrame.BytesFormatted += length;
+
+    DUI_printText(buffer, length);
+
+    _duiPrintTicks += SDL_GetPerformanceCounter() - start;
+}
+
+void DUI_PanelStart(const char * title, int width, int height, bool fixed)
+{
+    DUI_PanelStartEx(title, width, height, (fixed ? DUI_PANEL_FIXED : 0));
+}
+
+void DUI_PanelStartEx(const char * title, int width, int height, int flags)
+{
+    ++_duiStatsFrame.Panels;
+
+    DUI_PanelInfo * panel = DUI_pushPanel();
+    panel->Fixed = (flags & DUI_PANEL_FIXED);
+    panel->Title = title;
+    panel->Bounds.x = _duiCursor.x;
+    panel->Bounds.y = _duiCursor.y;
+    panel->Bounds.w = width + _duiStyle.PanelPadding;
+    panel->Bounds.h = height + _duiStyle.PanelPadding;
+
+    if (panel->Title) {
+        panel->Bounds.y += (_duiStyle.CharHeight / 2);
+        DUI_MoveCursorRelative(0, _duiStyle.CharHeight);
+    }
+
+    DUI_MoveCursorRelative(_duiStyle.PanelPadding, _duiStyle.PanelPadding);
+
+    // Reserve the background and border so they are drawn beneath the
+    //   contents, their bounds are filled in by DUI_PanelEnd
+    panel->Layer = _duiLayer;
+    panel->Command = _duiDrawList.CommandCount;
+
+    DUI_SetColorBackground();
+    DUI_DrawCommand * background = DUI_pushCommand(DUI_COMMAND_FILL_RECT, &panel->Bounds);
+
+    DUI_SetColorBorder();
+    DUI_DrawCommand * border = DUI_pushCommand(DUI_COMMAND_DRAW_RECT, &panel->Bounds);
+
+    DUI_DrawCommand * begin = DUI_pushCommand(DUI_COMMAND_PANEL_BEGIN, &panel->Bounds);
+
+    if (!background || !border || !begin) {
+        panel->Command = -1;
+        return;
+    }
+
+    begin->PanelFlags = flags;
+}
+
+void DUI_PanelEnd()
+{
+    DUI_PanelInfo * panel = DUI_getCurrentPanel();
+
+    panel->Bounds.w += _duiStyle.PanelPadding;
+    panel->Bounds.h += _duiStyle.PanelPadding;
+
+    SDL_Rect bounds = panel->Bounds;
+
+    DUI_Layer layer = _duiLayer;
+    _duiLayer = panel->Layer;
+
+    // The area covered by the panel and its title
+    SDL_Rect area = bounds;
+
+    if (panel->Title) {
+        SDL_Rect bounds = panel->Bounds;
+        bounds.x += _duiStyle.CharWidth;
+        bounds.y -= (_duiStyle.CharHeight / 2);
+        DUI_MeasureText(panel->Title, &bounds.w, &bounds.h);
+        bounds.w += (_duiStyle.CharWidth * 2);
+        
+        DUI_SetColorBackground();
+        DUI_fillRect(&bounds);
+
+        SDL_Point cursor = _duiCursor;
+        DUI_MoveCursor(bounds.x + _duiStyle.CharWidth, bounds.y);
+        DUI_printLabel(panel->Title);
+        DUI_MoveCursor(cursor.x, cursor.y);
+
+        SDL_UnionRect(&area, &bounds, &area);
+    }
+
+    if (panel->Command >= 0) {
+        DUI_DrawCommand * commands = &_duiDrawList.Commands[panel->Command];
+        commands[0].Bounds = bounds;
+        commands[1].Bounds = bounds;
+        commands[2].Bounds = area;
+    }
+
+    DUI_pushCommand(DUI_COMMAND_PANEL_END, &area);
+
+    _duiLayer = layer;
+
+    DUI_MoveCursor(panel->Bounds.x, 
+        panel->Bounds.y + panel->Bounds.h + _duiStyle.LinePadding);
+
+    DUI_popPanel();
+}
+
+bool DUI_Button(const char * text)
+{
+    ++_duiStatsFrame.Widgets;
+
+    int width, height;
+    DUI_MeasureText(text, &width, &height);
+
+    width += (_duiStyle.ButtonPadding * 2);
+    height += (_duiStyle.ButtonPadding * 2);
+
+    SDL_Rect bounds = {
+        .x = _duiCursor.x,
+        .y = _duiCursor.y,
+        .w = width,
+        .h = height,
+    };
+
+    bool hover = SDL_PointInRect(&_duiMouse, &bounds);
+    bool clicked = (hover && _duiClicked);
+
+    if (hover) {
+        DUI_SetColorHover();
+    }
+    else {
+        DUI_SetColorDefault();
+    }
+
+    DUI_fillRect(&bounds);
+
+    DUI_SetColorBorder();
+    DUI_drawRect(&bounds);
+
+    _duiCursor.x += _duiStyle.ButtonPadding;
+    _duiCursor.y += _duiStyle.ButtonPadding;
+
+    DUI_printLabel(text);
+
+    _duiCursor.x = bounds.x + bounds.w + _duiStyle.ButtonMargin;
+    _duiCursor.y = bounds.y;
+
+    return clicked;
+}
+
+bool DUI_ButtonAt(int x, int y, const char * text)
+{
+    SDL_Point tmp = _duiCursor;
+    _duiCursor.x = x;
+    _duiCursor.y = y;
+
+    bool clicked = DUI_Button(text);
+
+    _duiCursor = tmp;
+
+    return clicked;
+}
+
+bool DUI_Checkbox(const char * text, bool * checked)
+{
+    ++_duiStatsFrame.Widgets;
+
+    int width, height;
+    DUI_MeasureText(text, &width, &height);
+
+    width += (_duiStyle.CharWidth * 2)
+        + (_duiStyle.ButtonPadding * 2);
+    height += (_duiStyle.ButtonPadding * 2);
+
+    SDL_Rect bounds = {
+        .x = _duiCursor.x,
+        .y = _duiCursor.y,
+        .w = width,
+        .h = height,
+    };
+
+    bool hover = SDL_PointInRect(&_duiMouse, &bounds);
+    bool clicked = (hover && _duiClicked);
+
+    if (hover) {
+        DUI_SetColorHover();
+    }
+    else {
+        DUI_SetColorDefault();
+    }
+
+    DUI_fillRect(&bounds);
+
+    DUI_SetColorBorder();
+    DUI_drawRect(&bounds);
+
+    SDL_Rect mark = { 
+        .x = bounds.x + (_duiStyle.CharWidth / 2),
+        .y = bounds.y + (_duiStyle.CharHeight / 2),
+        .w = _duiStyle.CharWidth,
+        .h = _duiStyle.CharWidth,
+    };
+
+    DUI_drawRect(&mark);
+
+    if (clicked) {
+        *checked ^= true;
+    }
+
+    if (*checked) {
+        ++mark.x;
+        ++mark.y;
+        mark.w -= 2;
+        mark.h -= 2;
+
+        DUI_fillRect(&mark);
+    }
+
+    _duiCursor.x += _duiStyle.ButtonPadding
+        + _duiStyle.CharWidth
+        + (_duiStyle.CharWidth / 2);
+    _duiCursor.y += _duiStyle.ButtonPadding;
+
+    DUI_printLabel(text);
+
+    _duiCursor.x = bounds.x + bounds.w + _duiStyle.ButtonMargin;
+    _duiCursor.y = bounds.y;
+
+    return *checked;
+}
+
+bool DUI_CheckboxAt(int x, int y, const char * text, bool * checked)
+{
+    SDL_Point tmp = _duiCursor;
+    _duiCursor.x = x;
+    _duiCursor.y = y;
+
+    bool selected = DUI_Checkbox(text, checked);
+
+    _duiCursor = tmp;
+
+    return selected;
+}
+
+bool DUI_Radio(const char * text, int index, int * currentIndex)
+{
+    ++_duiStatsFrame.Widgets;
+
+    int width, height;
+    DUI_MeasureText(text, &width, &height);
+
+    width += (_duiStyle.CharWidth * 2)
+        + (_duiStyle.ButtonPadding * 2);
+    height += (_duiStyle.ButtonPadding * 2);
+
+    SDL_Rect bounds = {
+        .x = _duiCursor.x,
+        .y = _duiCursor.y,
+        .w = width,
+        .h = height,
+    };
+
+    bool hover = SDL_PointInRect(&_duiMouse, &bounds);
+    bool clicked = (hover && _duiClicked);
+
+    if (clicked) {
+        *currentIndex = index;
+    }
+
+    bool active = (*currentIndex == index);
+
+    if (hover) {
+        DUI_SetColorHover();
+    }
+    else {
+        DUI_SetColorDefault();
+    }
+
+    DUI_fillRect(&bounds);
+
+    DUI_SetColorBorder();
+    DUI_drawRect(&bounds);
+
+    SDL_Rect mark = { 
+        .x = bounds.x + (_duiStyle.CharWidth / 2),
+        .y = bounds.y + (_duiStyle.CharHeight / 2),
+        .w = _duiStyle.CharWidth, 
+        .h = _duiStyle.CharWidth
+    };
+
+    DUI_drawRect(&mark);
+
+    if (active) {
+        ++mark.x;
+        ++mark.y;
+        mark.w -= 2;
+        mark.h -= 2;
+
+        DUI_fillRect(&mark);
+    }
+
+    _duiCursor.x += _duiStyle.ButtonPadding
+        + _duiStyle.CharWidth
+        + (_duiStyle.CharWidth / 2);
+    _duiCursor.y += _duiStyle.ButtonPadding;
+    
+    DUI_printLabel(text);
+
+    _duiCursor.x = bounds.x + bounds.w + _duiStyle.ButtonMargin;
+    _duiCursor.y = bounds.y;
+
+    return active;
+}
+
+bool DUI_RadioAt(int x, int y, const char * text, int index, int * currentIndex)
+{
+    SDL_Point tmp = _duiCursor;
+    _duiCursor.x = x;
+    _duiCursor.y = y;
+
+    bool selected = DUI_Radio(text, index, currentIndex);
+
+    _duiCursor = tmp;
+
+    return selected;
+}
+
+void DUI_BeginTabBar()
+{
+    _duiTabCursor = _duiCursor;
+}
+
+bool DUI_Tab(const char * text, int index, int * currentIndex)
+{
+    ++_duiStatsFrame.Widgets;
+
+    _duiCursor = _duiTabCursor;
+
+    int width, height;
+    DUI_MeasureText(text, &width, &height);
+
+    width += (_duiStyle.TabPadding * 2);
+    height += (_duiStyle.TabPadding * 2);
+
+    SDL_Rect bounds = {
+        .x = _duiCursor.x,
+        .y = _duiCursor.y,
+        .w = width,
+        .h = height,
+    };
+
+    bool hover = SDL_PointInRect(&_duiMouse, &bounds);
+    bool clicked = (hover && _duiClicked);
+
+    if (clicked) {
+        *currentIndex = index;
+    }
+
+    bool active = (*currentIndex == index);
+
+    if (hover || active) {
+        DUI_SetColorHover();
+    }
+    else {
+        DUI_SetColorDefault();
+    }
+
+    DUI_fillRect(&bounds);
+
+    DUI_SetColorBorder();
+    DUI_drawRect(&bounds);
+
+    _duiCursor.x += _duiStyle.TabPadding;
+    _duiCursor.y += _duiStyle.TabPadding;
+    
+    DUI_printLabel(text);
+
+    _duiCursor.x = bounds.x + bounds.w + _duiStyle.TabMargin;
+    _duiCursor.y = bounds.y;
+
+    _duiTabCursor = _duiCursor;
+
+    return active;
+}
+
+// Draw a plot of values that have already been reduced to at most two per column
+void DUI_drawPlot(const char * label, const float * values, size_t count, 
+    float minimum, float maximum, int width, int height)
+{
+    ++_duiStatsFrame.Widgets;
+
+    SDL_Rect bounds = {
+        .x = _duiCursor.x,
+        .y = _duiCursor.y,
+        .w = width,
+        .h = height,
+    };
+
+    DUI_SetColorDefault();
+    DUI_fillRect(&bounds);
+
+    DUI_SetColorBorder();
+    DUI_drawRect(&bounds);
+
+    // The area inside the border
+    SDL_Rect plot = { bounds.x + 1, bounds.y + 1, bounds.w - 2, bounds.h - 2 };
+
+    SDL_Point * points = NULL;
+    if (count >= 2 && plot.w >= 2 && plot.h >= 1) {
+        points = DUI_pushLines(&plot, count);
+    }
+
+    // The line is drawn with ColorBorder, which stands out from ColorDefault
+    if (points) {
+        float range = maximum - minimum;
+        float scale = (range > 0.0f ? (plot.h - 1) / range : 0.0f);
+        int bottom = plot.y + plot.h - 1;
+
+        for (size_t i = 0; i < count; ++i) {
+            int y = (range > 0.0f 
+                ? bottom - (int)((values[i] - minimum) * scale)
+                : plot.y + (plot.h / 2));
+
+            points[i].x = plot.x + (int)((i * (plot.w - 1)) / (count - 1));
+            points[i].y = SDL_max(plot.y, SDL_min(y, bottom));
+        }
+    }
+
+    if (label) {
+        DUI_PrintAt(bounds.x + _duiStyle.ButtonPadding, bounds.y + _duiStyle.ButtonPadding, 
+            "%s [%g, %g]", label, minimum, maximum);
+    }
+
+    _duiCursor.x = bounds.x + bounds.w;
+    _duiCursor.y = bounds.y + bounds.h;
+    DUI_growPanel();
+
+    _duiCursor.x = _duiLineStart;
+    _duiCursor.y += _duiStyle.LinePadding;
+}
+
+void DUI_PlotLines(const char * label, const float * data, size_t count, int width, int height)
+{
+    // The number of columns inside the border
+    size_t columns = (size_t)SDL_max(width - 2, 1);
+
+    size_t valueCount = SDL_min(count, columns * 2);
+    if (count == 0 || !DUI_reserve((void **)&_duiPlotValues, &_duiPlotValueCapacity, 
+            valueCount, sizeof(float))) {
+        DUI_drawPlot(label, NULL, 0, 0.0f, 0.0f, width, height);
+        return;
+    }
+
+    float * values = _duiPlotValues;
+    float minimum = data[0];
+    float maximum = data[0];
+
+    if (valueCount == count) {
+        for (size_t i = 0; i < count; ++i) {
+            values[i] = data[i];
+            minimum = SDL_min(minimum, data[i]);
+            maximum = SDL_max(maximum, data[i]);
+        }
+    }
+    else {
+        // Keep the minimum and maximum of each column, in the order they occur
+        for (size_t x = 0; x < columns; ++x) {
+            size_t first = (count * x) / columns;
+            size_t last = (count * (x + 1)) / columns;
+
+            size_t low = first;
+            size_t high = first;
+            for (size_t i = first + 1; i < last; ++i) {
+                if (data[i] < data[low]) {
+                    low = i;
+                }
+                if (data[i] > data[high]) {
+                    high = i;
+                }
+            }
+
+            values[x * 2] = data[SDL_min(low, high)];
+            values[x * 2 + 1] = data[SDL_max(low, high)];
+
+            minimum = SDL_min(minimum, data[low]);
+            maximum = SDL_max(maximum, data[high]);
+        }
+    }
+
+    DUI_drawPlot(label, values, valueCount, minimum, maximum, width, height);
+}
+
+struct DUI_Series
+{
+    // The most recent samples, indexed by their position modulo Capacity
+    float * Samples;
+    size_t Capacity;
+
+    // The number of samples ever appended
+    uint64_t Total;
+
+    // Levels[n] summarizes 2^n samples per bucket, Levels[0] is unused
+    DUI_SeriesBucket * Levels[64];
+    int LevelCount;
+
+};
+
+DUI_Series * DUI_CreateSeries(size_t capacity)
+{
+    size_t size = 2;
+    int levelCount = 2;
+    while (size < capacity) {
+        size *= 2;
+        ++levelCount;
+    }
+
+    // Every level above the samples together hold one bucket per sample
+    DUI_Series * series = SDL_malloc(sizeof(DUI_Series) 
+        + (size * sizeof(float)) 
+        + (size * sizeof(DUI_SeriesBucket)));
+
+    if (!series) {
+        return NULL;
+    }
+
+    *series = (DUI_Series){
+        .Samples = (float *)(series + 1),
+        .Capacity = size,
+        .LevelCount = levelCount,
+    };
+
+    DUI_SeriesBucket * buckets = (DUI_SeriesBucket *)(series->Samples + size);
+    for (int level = 1; level < levelCount; ++level) {
+        series->Levels[level] = buckets;
+        buckets += (size >> level);
+    }
+
+    return series;
+}
+
+void DUI_DestroySeries(DUI_Series * series)
+{
+    SDL_free(series);
+}
+
+DUI_SeriesBucket DUI_getSeriesBucket(const DUI_Series * series, int level, uint64_t index)
+{
+    if (level == 0) {
+        float sample = series->Samples[index & (series->Capacity - 1)];
+        return (DUI_SeriesBucket){ sample, sample, sample };
+    }
+
+    return series->Levels[level][index & ((series->Capacity >> level) - 1)];
+}
+
+void DUI_SeriesAppend(DUI_Series * series, float value)
+{
+    uint64_t index = series->Total++;
+    series->Samples[index & (series->Capacity - 1)] = value;
+
+    // Complete the bucket on each level that ends with this sample
+    DUI_SeriesBucket right = { value, value, value };
+
+    for (int level = 1; level < series->LevelCount; ++level) {
+        if (((index + 1) & ((1ull << level) - 1)) != 0) {
+            break;
+        }
+
+        uint64_t bucket = (index >> level);
+        DUI_SeriesBucket left = DUI_getSeriesBucket(series, level - 1, (bucket * 2));
+
+        right = (DUI_SeriesBucket){
+            .Min = SDL_min(left.Min, right.Min),
+            .Max = SDL_max(left.Max, right.Max),
+            .Mean = (left.Mean + right.Mean) * 0.5f,
+        };
+
+        series->Levels[level][bucket & ((series->Capacity >> level) - 1)] = right;
+    }
+}
+
+size_t DUI_SeriesCount(const DUI_Series * series)
+{
+    return (size_t)SDL_min(series->Total, (uint64_t)series->Capacity);
+}
+
+size_t DUI_SeriesQuery(const DUI_Series * series, size_t first, size_t count, 
+    DUI_SeriesBucket * buckets, size_t bucketCount)
+{
+    size_t available = DUI_SeriesCount(series);
+    if (first >= available) {
+        return 0;
+    }
+
+    count = SDL_min(count, available - first);
+    bucketCount = SDL_min(bucketCount, count);
+
+    uint64_t start = series->Total - available + first;
+
+    for (size_t i = 0; i < bucketCount; ++i) {
+        uint64_t a = start + (count * i) / bucketCount;
+        uint64_t b = start + (count * (i + 1)) / bucketCount;
+
+        DUI_SeriesBucket result = DUI_getSeriesBucket(series, 0, a);
+        double sum = 0.0;
+
+        // Cover the range with the largest aligned buckets that fit in it
+        while (a < b) {
+            int level = 0;
+            while (level + 1 < series->LevelCount 
+                && (a & ((2ull << level) - 1)) == 0 
+                && a + (2ull << level) <= b) {
+                ++level;
+            }
+
+            DUI_SeriesBucket bucket = DUI_getSeriesBucket(series, level, a >> level);
+            result.Min = SDL_min(result.Min, bucket.Min);
+            result.Max = SDL_max(result.Max, bucket.Max);
+            sum += (double)bucket.Mean * (1ull << level);
+
+            a += (1ull << level);
+        }
+
+        result.Mean = (float)(sum / (double)(b - (start + (count * i) / bucketCount)));
+        buckets[i] = result;
+    }
+
+    return bucketCount;
+}
+
+void DUI_PlotSeries(const char * label, const DUI_Series * series, size_t first, size_t count, 
+    int width, int height)
+{
+    size_t columns = (size_t)SDL_max(width - 2, 1);
+
+    // Show individual samples until there are two per column
+    size_t bucketCount = (count > columns * 2 ? columns : columns * 2);
+
+    if (!DUI_reserve((void **)&_duiPlotBuckets, &_duiPlotBucketCapacity, 
+            bucketCount, sizeof(DUI_SeriesBucket))
+        || !DUI_reserve((void **)&_duiPlotValues, &_duiPlotValueCapacity, 
+            columns * 2, sizeof(float))) {
+        DUI_drawPlot(label, NULL, 0, 0.0f, 0.0f, width, height);
+        return;
+    }
+
+    bucketCount = DUI_SeriesQuery(series, first, count, _duiPlotBuckets, bucketCount);
+    if (bucketCount == 0) {
+        DUI_drawPlot(label, NULL, 0, 0.0f, 0.0f, width, height);
+        return;
+    }
+
+    float * values = _duiPlotValues;
+    float minimum = _duiPlotBuckets[0].Min;
+    float maximum = _duiPlotBuckets[0].Max;
+    size_t valueCount = 0;
+
+    for (size_t i = 0; i < bucketCount; ++i) {
+        const DUI_SeriesBucket * bucket = &_duiPlotBuckets[i];
+
+        if (bucket->Min == bucket->Max) {
+            values[valueCount++] = bucket->Min;
+        }
+        else {
+            values[valueCount++] = bucket->Min;
+            values[valueCount++] = bucket->Max;
+        }
+
+        minimum = SDL_min(minimum, bucket->Min);
+        maximum = SDL_max(maximum, bucket->Max);
+    }
+
+    DUI_drawPlot(label, values, valueCount, minimum, maximum, width, height);
+}
+
+// The histogram is sorted into this many copies of the counts, so that 
+//   consecutive samples in the same bucket don't wait on each other
+#define DUI_HISTOGRAM_LANES (4)
+
+// Samples are clamped to this before taking their log
+#define DUI_HISTOGRAM_LOG_MIN (1e-30f)
+
+// Approximate log2, accurate to about 1e-4, the vector versions must match
+float DUI_fastLog2(float x)
+{
+    union { float f; uint32_t i; } bits = { x };
+    float exponent = (float)((int)(bits.i >> 23) - 127);
+
+    bits.i = (bits.i & 0x007FFFFF) | 0x3F800000;
+    float m = bits.f;
+
+    // ln(m) for m in [1, 2), converted to log2
+    float p = -1.7417939f 
+        + (2.8212026f + (-1.4699568f + (0.44717955f - 0.056570851f * m) * m) * m) * m;
+    return exponent + p * 1.44269504f;
+}
+
+// Count each sample in bucket (f(sample) - offset) * scale, where f is log2 or nothing
+void DUI_binScalar(const float * data, size_t count, float offset, float scale, 
+    int buckets, bool log, uint32_t * counts)
+{
+    float last = (float)(buckets - 1);
+
+    for (size_t i = 0; i < count; ++i) {
+        float x = data[i];
+        if (log) {
+            x = DUI_fastLog2(x > DUI_HISTOGRAM_LOG_MIN ? x : DUI_HISTOGRAM_LOG_MIN);
+        }
+
+        // NaN is counted in the first bucket, the same as _mm_max_ps
+        float t = (x - offset) * scale;
+        t = (t > 0.0f ? t : 0.0f);
+        t = (t < last ? t : last);
+
+        ++counts[(i % DUI_HISTOGRAM_LANES) * buckets + (int)t];
+    }
+}
+
+#if defined(DUI_X86_64)
+
+__m128 DUI_fastLog2SSE2(__m128 x)
+{
+    __m128i bits = _mm_castps_si128(x);
+    __m128 exponent = _mm_cvtepi32_ps(
+        _mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+
+    __m128 m = _mm_castsi128_ps(_mm_or_si128(
+        _mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)), _mm_set1_epi32(0x3F800000)));
+
+    __m128 p = _mm_sub_ps(_mm_set1_ps(0.44717955f), _mm_mul_ps(_mm_set1_ps(0.056570851f), m));
+    p = _mm_add_ps(_mm_set1_ps(-1.4699568f), _mm_mul_ps(p, m));
+    p = _mm_add_ps(_mm_set1_ps(2.8212026f), _mm_mul_ps(p, m));
+    p = _mm_sub_ps(_mm_mul_ps(p, m), _mm_set1_ps(1.7417939f));
+
+    return _mm_add_ps(exponent, _mm_mul_ps(p, _mm_set1_ps(1.44269504f)));
+}
+
+void DUI_binSSE2(const float * data, size_t count, float offset, float scale, 
+    int buckets, bool log, uint32_t * counts)
+{
+    const __m128 vOffset = _mm_set1_ps(offset);
+    const __m128 vScale = _mm_set1_ps(scale);
+    const __m128 vLast = _mm_set1_ps((float)(buckets - 1));
+    const __m128 vLogMin = _mm_set1_ps(DUI_HISTOGRAM_LOG_MIN);
+    const __m128 vZero = _mm_setzero_ps();
+
+    int indices[4];
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(data + i);
+        if (log) {
+            x = DUI_fastLog2SSE2(_mm_max_ps(x, vLogMin));
+        }
+
+        __m128 t = _mm_mul_ps(_mm_sub_ps(x, vOffset), vScale);
+        t = _mm_min_ps(_mm_max_ps(t, vZero), vLast);
+
+        _mm_storeu_si128((__m128i *)indices, _mm_cvttps_epi32(t));
+
+        ++counts[indices[0]];
+        ++counts[buckets + indices[1]];
+        ++counts[(buckets * 2) + indices[2]];
+        ++counts[(buckets * 3) + indices[3]];
+    }
+
+    DUI_binScalar(data + i, count - i, offset, scale, buckets, log, counts);
+}
+
+DUI_TARGET_AVX2
+__m256 DUI_fastLog2AVX2(__m256 x)
+{
+    __m256i bits = _mm256_castps_si256(x);
+    __m256 exponent = _mm256_cvtepi32_ps(
+        _mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(127)));
+
+    __m256 m = _mm256_castsi256_ps(_mm256_or_si256(
+        _mm256_and_si256(bits, _mm256_set1_epi32(0x007FFFFF)), _mm256_set1_epi32(0x3F800000)));
+
+    __m256 p = _mm256_sub_ps(_mm256_set1_ps(0.44717955f), _mm256_mul_ps(_mm256_set1_ps(0.056570851f), m));
+    p = _mm256_add_ps(_mm256_set1_ps(-1.4699568f), _mm256_mul_ps(p, m));
+    p = _mm256_add_ps(_mm256_set1_ps(2.8212026f), _mm256_mul_ps(p, m));
+    p = _mm256_sub_ps(_mm256_mul_ps(p, m), _mm256_set1_ps(1.7417939f));
+
+    return _mm256_add_ps(exponent, _mm256_mul_ps(p, _mm256_set1_ps(1.44269504f)));
+}
+
+DUI_TARGET_AVX2
+void DUI_binAVX2(const float * data, size_t count, float offset, float scale, 
+    int buckets, bool log, uint32_t * counts)
+{
+    const __m256 vOffset = _mm256_set1_ps(offset);
+    const __m256 vScale = _mm256_set1_ps(scale);
+    const __m256 vLast = _mm256_set1_ps((float)(buckets - 1));
+    const __m256 vLogMin = _mm256_set1_ps(DUI_HISTOGRAM_LOG_MIN);
+    const __m256 vZero = _mm256_setzero_ps();
+
+    int indices[8];
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_loadu_ps(data + i);
+        if (log) {
+            x = DUI_fastLog2AVX2(_mm256_max_ps(x, vLogMin));
+        }
+
+        __m256 t = _mm256_mul_ps(_mm256_sub_ps(x, vOffset), vScale);
+        t = _mm256_min_ps(_mm256_max_ps(t, vZero), vLast);
+
+        _mm256_storeu_si256((__m256i *)indices, _mm256_cvttps_epi32(t));
+
+        for (int j = 0; j < 8; ++j) {
+            ++counts[(j % DUI_HISTOGRAM_LANES) * buckets + indices[j]];
+        }
+    }
+
+    DUI_binScalar(data + i, count - i, offset, scale, buckets, log, counts);
+}
+
+#endif // DUI_X86_64
+
+void DUI_binSamples(const float * data, size_t count, float offset, float scale, 
+    int buckets, bool log, uint32_t * counts)
+{
+#if defined(DUI_X86_64)
+    if (SDL_HasAVX2()) {
+        DUI_binAVX2(data, count, offset, scale, buckets, log, counts);
+    }
+    else {
+        DUI_binSSE2(data, count, offset, scale, buckets, log, counts);
+    }
+#else
+    DUI_binScalar(data, count, offset, scale, buckets, log, counts);
+#endif
+}
+
+void DUI_Histogram(const char * label, const float * data, size_t count, int buckets,
+    float minimum, float maximum, DUI_HistogramScale scale, int width, int height)
+{
+    ++_duiStatsFrame.Widgets;
+
+    bool log = (scale == DUI_HISTOGRAM_LOG);
+
+    SDL_Rect bounds = {
+        .x = _duiCursor.x,
+        .y = _duiCursor.y,
+        .w = width,
+        .h = height,
+    };
+
+    DUI_SetColorDefault();
+    DUI_fillRect(&bounds);
+
+    DUI_SetColorBorder();
+    DUI_drawRect(&bounds);
+
+    SDL_Rect plot = { bounds.x + 1, bounds.y + 1, bounds.w - 2, bounds.h - 2 };
+    buckets = SDL_min(buckets, plot.w);
+
+    if (maximum <= minimum && count > 0) {
+        minimum = data[0];
+        maximum = data[0];
+        for (size_t i = 1; i < count; ++i) {
+            minimum = SDL_min(minimum, data[i]);
+            maximum = SDL_max(maximum, data[i]);
+        }
+
+        if (log) {
+            minimum = SDL_max(minimum, maximum * 1e-6f);
+        }
+    }
+
+    if (log) {
+        minimum = SDL_max(minimum, DUI_HISTOGRAM_LOG_MIN);
+        maximum = SDL_max(maximum, minimum);
+    }
+
+    bool valid = (buckets > 0 && plot.h > 0 && count > 0 
+        && DUI_reserve((void **)&_duiHistogramCounts, &_duiHistogramCountCapacity, 
+            (size_t)buckets * DUI_HISTOGRAM_LANES, sizeof(uint32_t)));
+
+    SDL_Rect hoveredBar = { 0, 0, 0, 0 };
+    int hovered = -1;
+    uint32_t hoveredCount = 0;
+
+    if (valid) {
+        uint32_t * counts = _duiHistogramCounts;
+        SDL_memset(counts, 0, (size_t)buckets * DUI_HISTOGRAM_LANES * sizeof(uint32_t));
+
+        float offset = (log ? DUI_fastLog2(minimum) : minimum);
+        float range = (log ? DUI_fastLog2(maximum) : maximum) - offset;
+        float binScale = (range > 0.0f ? buckets / range : 0.0f);
 
-SDL_Point _duiMouse     = { 0, 0 };
-SDL_Point _duiCursor    = { 0, 0 };
-SDL_Point _duiTabCursor = { 0, 0 };
+        DUI_binSamples(data, count, offset, binScale, buckets, log, counts);
 
-int _duiWindowWidth;
-int _duiWindowHeight;
+        uint32_t highest = 1;
+        for (int i = 0; i < buckets; ++i) {
+            for (int lane = 1; lane < DUI_HISTOGRAM_LANES; ++lane) {
+                counts[i] += counts[(lane * buckets) + i];
+            }
+            highest = SDL_max(highest, counts[i]);
+        }
 
-bool _duiMouseDown = false;
-bool _duiClicked = false;
+        // All the bars are the same color, so they are drawn with one call
+        DUI_SetColorHover();
 
-DUI_PanelInfo * DUI_getCurrentPanel()
-{
-    return &_duiPanelStack[_duiPanelStackIndex];
-}
+        for (int i = 0; i < buckets; ++i) {
+            int x0 = plot.x + (i * plot.w) / buckets;
+            int x1 = plot.x + ((i + 1) * plot.w) / buckets;
+            int barHeight = (int)(((uint64_t)counts[i] * plot.h) / highest);
+
+            SDL_Rect bar = { x0, plot.y + plot.h - barHeight, x1 - x0, barHeight };
+            if (bar.h > 0) {
+                DUI_fillRect(&bar);
+            }
+
+            SDL_Rect column = { x0, plot.y, x1 - x0, plot.h };
+            if (SDL_PointInRect(&_duiMouse, &column)) {
+                hovered = i;
+                hoveredCount = counts[i];
+                hoveredBar = column;
+            }
+        }
+    }
 
-void DUI_popPanel()
-{
-    --_duiPanelStackIndex;
+    if (label || hovered >= 0) {
+        int tmpX, tmpY;
+        DUI_GetCursor(&tmpX, &tmpY);
+        DUI_MoveCursor(bounds.x + _duiStyle.ButtonPadding, bounds.y + _duiStyle.ButtonPadding);
+
+        if (label) {
+            DUI_Print("%s ", label);
+        }
+
+        if (hovered >= 0) {
+            float low, high;
+            if (log) {
+                float ratio = maximum / minimum;
+                low = minimum * SDL_powf(ratio, (float)hovered / buckets);
+                high = minimum * SDL_powf(ratio, (float)(hovered + 1) / buckets);
+            }
+            else {
+                low = minimum + ((maximum - minimum) * hovered) / buckets;
+                high = minimum + ((maximum - minimum) * (hovered + 1)) / buckets;
+            }
+
+            DUI_Print("[%g, %g): %u", low, high, hoveredCount);
+
+            DUI_SetColorBorder();
+            DUI_drawRect(&hoveredBar);
+        }
+
+        DUI_MoveCursor(tmpX, tmpY);
+    }
+
+    _duiCursor.x = bounds.x + bounds.w;
+    _duiCursor.y = bounds.y + bounds.h;
+    DUI_growPanel();
+
+    _duiCursor.x = _duiLineStart;
+    _duiCursor.y += _duiStyle.LinePadding;
 }
 
-DUI_PanelInfo * DUI_pushPanel()
+// Colors for bars, dark enough for text to be read on top of them
+const uint8_t DUI_BAR_COLORS[][4] = {
+    { 0x3A, 0x5F, 0x8F, 0xFF },
+    { 0x8F, 0x4A, 0x3A, 0xFF },
+    { 0x3A, 0x8F, 0x5A, 0xFF },
+    { 0x7A, 0x3A, 0x8F, 0xFF },
+    { 0x8F, 0x7A, 0x3A, 0xFF },
+    { 0x3A, 0x80, 0x8F, 0xFF },
+};
+
+// Pick a color for a bar, names are usually string literals so the same
+//   name gets the same color
+const uint8_t * DUI_getNameColor(const char * name)
 {
-    ++_duiPanelStackIndex;
-    DUI_PanelInfo * panel = DUI_getCurrentPanel();
-    panel->Bounds = (SDL_Rect){ 0, 0, 0, 0 };
-    return panel;
+    return DUI_BAR_COLORS[((uintptr_t)name >> 3) % SDL_arraysize(DUI_BAR_COLORS)];
 }
 
-void DUI_growPanel()
+void DUI_FlameGraph(const char * label, const DUI_FlameNode * nodes, size_t count, int * zoom, 
+    int width, int height)
 {
-    DUI_PanelInfo * panel = DUI_getCurrentPanel();
-    if (panel->Fixed) {
-        return;
-    }
+    ++_duiStatsFrame.Widgets;
 
-    int x = (_duiCursor.x - panel->Bounds.x);
-    int y = (_duiCursor.y - panel->Bounds.y);
+    SDL_Rect bounds = {
+        .x = _duiCursor.x,
+        .y = _duiCursor.y,
+        .w = width,
+        .h = height,
+    };
 
-    if (x > panel->Bounds.w) {
-        panel->Bounds.w = x;
+    DUI_SetColorDefault();
+    DUI_fillRect(&bounds);
+
+    DUI_SetColorBorder();
+    DUI_drawRect(&bounds);
+
+    int rowHeight = _duiStyle.CharHeight + _duiStyle.ButtonPadding;
+
+    SDL_Rect plot = { bounds.x + 1, bounds.y + 1, bounds.w - 2, bounds.h - 2 };
+
+    if (label) {
+        DUI_PrintAt(plot.x + _duiStyle.ButtonPadding, plot.y + (_duiStyle.ButtonPadding / 2), 
+            "%s", label);
+        plot.y += rowHeight;
+        plot.h -= rowHeight;
     }
 
-    if (y > panel->Bounds.h) {
-        panel->Bounds.h = y;
+    if (*zoom < 0 || (size_t)*zoom >= count) {
+        *zoom = -1;
     }
-}
 
-void DUI_Init(SDL_Window * window)
-{
-    _duiWindow = window;
-    _duiRenderer = SDL_GetRenderer(window);
-    _duiWindowID = SDL_GetWindowID(window);
+    // Link each node to its first child and next sibling, keeping the order of the array
+    bool valid = (count > 0 && count < INT32_MAX && plot.w > 0 
+        && DUI_reserve((void **)&_duiFlameLinks, &_duiFlameLinkCapacity, 
+            count * 2, sizeof(int))
+        && DUI_reserve((void **)&_duiFlameStack, &_duiFlameStackCapacity, 
+            count, sizeof(DUI_FlameVisit)));
 
-    SDL_SetRenderDrawBlendMode(_duiRenderer, SDL_BLENDMODE_BLEND);
+    int hovered = -1;
 
-    SDL_GetWindowSize(window, &_duiWindowWidth, &_duiWindowHeight);
+    if (valid) {
+        int * firstChild = _duiFlameLinks;
+        int * nextSibling = _duiFlameLinks + count;
+        int firstRoot = -1;
 
-    int pitch;
-    void * pixels;
+        for (size_t i = 0; i < count; ++i) {
+            firstChild[i] = -1;
+        }
 
-    // The Window's Rendering Target
-    _duiPanelStack[0].Fixed = true;
-    _duiPanelStack[0].Bounds = (SDL_Rect){ 0, 0, _duiWindowWidth, _duiWindowHeight };
-    _duiPanelStack[0].Title = NULL;
-    _duiPanelStack[0].Texture = NULL;
+        for (int i = (int)count - 1; i >= 0; --i) {
+            int parent = nodes[i].Parent;
+
+            if (parent >= 0 && (size_t)parent < count && parent != i) {
+                nextSibling[i] = firstChild[parent];
+                firstChild[parent] = i;
+            }
+            else {
+                nextSibling[i] = firstRoot;
+                firstRoot = i;
+            }
+        }
 
-    for (int i = 1; i <= DUI_PANEL_STACK_DEPTH; ++i) {
-        _duiPanelStack[i].Texture = SDL_CreateTexture(_duiRenderer, 
-            SDL_PIXELFORMAT_RGBA32,
-            SDL_TEXTUREACCESS_TARGET,
-            _duiWindowWidth, _duiWindowHeight);
+        uint64_t total = 0;
+        if (*zoom >= 0) {
+            total = nodes[*zoom].TotalTicks;
+            firstRoot = *zoom;
+        }
+        else {
+            for (int i = firstRoot; i >= 0; i = nextSibling[i]) {
+                total += nodes[i].TotalTicks;
+            }
+        }
+
+        double scale = (total > 0 ? (double)plot.w / total : 0.0);
+        int maxDepth = (plot.h / rowHeight) - 1;
+
+        DUI_FlameVisit * stack = _duiFlameStack;
+        size_t stackSize = 0;
+
+        double x = 0.0;
+        for (int i = firstRoot; i >= 0; i = (*zoom >= 0 ? -1 : nextSibling[i])) {
+            stack[stackSize++] = (DUI_FlameVisit){ i, 0, x };
+            x += nodes[i].TotalTicks * scale;
+        }
 
-        SDL_SetTextureBlendMode(_duiPanelStack[i].Texture, SDL_BLENDMODE_BLEND);
+        while (stackSize > 0) {
+            DUI_FlameVisit visit = stack[--stackSize];
+            const DUI_FlameNode * node = &nodes[visit.Node];
+
+            // Nodes narrower than a pixel, and everything inside them, are skipped
+            double nodeWidth = node->TotalTicks * scale;
+            if (nodeWidth < 1.0 || visit.Depth > maxDepth) {
+                continue;
+            }
+
+            int x0 = plot.x + (int)visit.X;
+            int x1 = plot.x + (int)(visit.X + nodeWidth);
+
+            SDL_Rect bar = {
+                .x = x0,
+                .y = plot.y + (visit.Depth * rowHeight),
+                .w = SDL_max(x1 - x0, 1) - 1,
+                .h = rowHeight - 1,
+            };
+
+            if (bar.w <= 0) {
+                bar.w = 1;
+            }
+
+            DUI_setDrawColor(DUI_getNameColor(node->Name));
+            DUI_fillRect(&bar);
+
+            int characters = (bar.w - 2) / _duiStyle.CharWidth;
+            if (node->Name && characters > 0) {
+                int length = (int)DUI_characterPrefix(node->Name, strlen(node->Name), characters);
+                DUI_PrintAt(bar.x + 1, bar.y + (_duiStyle.ButtonPadding / 2), 
+                    "%.*s", length, node->Name);
+            }
+
+            if (SDL_PointInRect(&_duiMouse, &bar)) {
+                hovered = visit.Node;
+            }
+
+            double childX = visit.X;
+            for (int child = firstChild[visit.Node]; child >= 0; child = nextSibling[child]) {
+                double childWidth = nodes[child].TotalTicks * scale;
+
+                if (childWidth >= 1.0 && stackSize < count) {
+                    stack[stackSize++] = (DUI_FlameVisit){ child, visit.Depth + 1, childX };
+                }
+
+                childX += childWidth;
+            }
+        }
+
+        if (hovered >= 0 && _duiClicked) {
+            // Clicking the node filling the width zooms back out to its parent
+            if (hovered == *zoom) {
+                int parent = nodes[hovered].Parent;
+                *zoom = (parent >= 0 && (size_t)parent < count ? parent : -1);
+            }
+            else {
+                *zoom = hovered;
+            }
+        }
     }
 
-    _duiOverlayTexture = SDL_CreateTexture(_duiRenderer, 
-            SDL_PIXELFORMAT_RGBA32,
-            SDL_TEXTUREACCESS_TARGET,
-            _duiWindowWidth, _duiWindowHeight);
+    if (hovered >= 0) {
+        const DUI_FlameNode * node = &nodes[hovered];
+        uint64_t rootTotal = SDL_max(*zoom >= 0 ? nodes[*zoom].TotalTicks : 0, 1);
 
-    SDL_SetTextureBlendMode(_duiOverlayTexture, SDL_BLENDMODE_BLEND);
+        DUI_Layer layer = _duiLayer;
+        DUI_SetLayer(DUI_LAYER_OVERLAY);
 
-    SDL_RWops * fontMem = SDL_RWFromConstMem(DUI_FONT_BMP, sizeof(DUI_FONT_BMP));
-    SDL_Surface * fontSurface = SDL_LoadBMP_RW(fontMem, 1);
+        int tmpX, tmpY;
+        DUI_GetCursor(&tmpX, &tmpY);
 
-    _duiFontTexture = SDL_CreateTextureFromSurface(_duiRenderer, fontSurface);
-    SDL_FreeSurface(fontSurface);
+        SDL_Rect tooltip = {
+            .x = _duiMouse.x + _duiStyle.CharWidth,
+            .y = _duiMouse.y + _duiStyle.CharHeight,
+            .w = (_duiStyle.CharWidth * 32) + (_duiStyle.ButtonPadding * 2),
+            .h = (_duiStyle.CharHeight * 3) + (_duiStyle.LinePadding * 2) 
+                + (_duiStyle.ButtonPadding * 2),
+        };
 
-    SDL_SetRenderTarget(_duiRenderer, _duiPanelStack[0].Texture);
-}
+        DUI_SetColorBackground();
+        DUI_fillRect(&tooltip);
 
-void DUI_Term()
-{
-    SDL_DestroyTexture(_duiFontTexture);
-        
-    for (int i = 1; i < DUI_PANEL_STACK_DEPTH; ++i) {
-        SDL_DestroyTexture(_duiPanelStack[i].Texture);
-        _duiPanelStack[i].Texture = NULL;
+        DUI_SetColorBorder();
+        DUI_drawRect(&tooltip);
+
+        DUI_MoveCursor(tooltip.x + _duiStyle.ButtonPadding, tooltip.y + _duiStyle.ButtonPadding);
+        DUI_Println("%.32s", (node->Name ? node->Name : "?"));
+        if (*zoom >= 0) {
+            DUI_Println("TOTAL %llu (%.1f%%)", 
+                (unsigned long long)node->TotalTicks, (100.0 * node->TotalTicks) / rootTotal);
+        }
+        else {
+            DUI_Println("TOTAL %llu", (unsigned long long)node->TotalTicks);
+        }
+        DUI_Println("SELF %llu", (unsigned long long)node->SelfTicks);
+
+        DUI_MoveCursor(tmpX, tmpY);
+        DUI_SetLayer(layer);
     }
-}
 
-void DUI_Update()
-{
-    int state = SDL_GetMouseState(&_duiMouse.x, &_duiMouse.y);
-    bool pressed = (state & SDL_BUTTON(SDL_BUTTON_LEFT));
-    _duiClicked = (pressed && !_duiMouseDown);
-    _duiMouseDown = pressed;
-}
+    _duiCursor.x = bounds.x + bounds.w;
+    _duiCursor.y = bounds.y + bounds.h;
+    DUI_growPanel();
 
-void DUI_Render()
-{
+    _duiCursor.x = _duiLineStart;
+    _duiCursor.y += _duiStyle.LinePadding;
 }
 
-void DUI_SetStyle(DUI_Style style)
+void DUI_ProfileBegin(const char * name)
 {
-    _duiStyle = style;
-}
+    DUI_ProfileThread * thread = DUI_getProfileThread();
+    if (!thread) {
+        return;
+    }
 
-DUI_Style * DUI_GetStyle()
-{
-    return &_duiStyle;
-}
+    if (thread->Depth < DUI_PROFILE_MAX_DEPTH) {
+        uint32_t head = (uint32_t)SDL_AtomicGet(&thread->Head);
+        DUI_ProfileEvent * event = &thread->Events[head & (DUI_PROFILE_RING_SIZE - 1)];
+        event->Name = name;
+        event->Depth = thread->Depth;
+        event->End = 0;
+        event->Start = SDL_GetPerformanceCounter();
 
-void DUI_SetColorBackground()
-{
-    SDL_SetRenderDrawColor(_duiRenderer, 
-        _duiStyle.ColorBackground[0],
-        _duiStyle.ColorBackground[1],
-        _duiStyle.ColorBackground[2],
-        _duiStyle.ColorBackground[3]);
+        thread->Stack[thread->Depth] = head;
+
+        // Publish the event to DUI_ProfilerPanel, which can be on another thread
+        SDL_AtomicSet(&thread->Head, (int)(head + 1));
+    }
+
+    ++thread->Depth;
 }
 
-void DUI_SetColorBorder()
+void DUI_ProfileEnd()
 {
-    SDL_SetRenderDrawColor(_duiRenderer, 
-        _duiStyle.ColorBorder[0],
-        _duiStyle.ColorBorder[1],
-        _duiStyle.ColorBorder[2],
-        _duiStyle.ColorBorder[3]);
+    DUI_ProfileThread * thread = _duiProfileThread;
+    if (!thread || thread->Depth == 0) {
+        return;
+    }
+
+    --thread->Depth;
+
+    if (thread->Depth < DUI_PROFILE_MAX_DEPTH) {
+        uint32_t index = thread->Stack[thread->Depth];
+
+        // Scopes that outlive the ring buffer have already been overwritten
+        if ((uint32_t)SDL_AtomicGet(&thread->Head) - index <= DUI_PROFILE_RING_SIZE) {
+            thread->Events[index & (DUI_PROFILE_RING_SIZE - 1)].End = SDL_GetPerformanceCounter();
+        }
+    }
 }
 
-void DUI_SetColorHover()
+// Events copied out of a thread's ring buffer, only used on the thread
+//   calling DUI_Update
+DUI_ProfileEvent _duiProfileCopy[DUI_PROFILE_RING_SIZE];
+
+// Copy the events a thread has published into _duiProfileCopy, and discard 
+//   any the thread may have overwritten while they were copied. The End of
+//   a scope still open can be set by DUI_ProfileEnd at any time, so it is
+//   copied as either 0 or the time the scope ended.
+size_t DUI_copyProfileEvents(DUI_ProfileThread * thread)
 {
-    SDL_SetRenderDrawColor(_duiRenderer, 
-        _duiStyle.ColorHover[0],
-        _duiStyle.ColorHover[1],
-        _duiStyle.ColorHover[2],
-        _duiStyle.ColorHover[3]);
+    if (!SDL_AtomicGet(&thread->Ready)) {
+        return 0;
+    }
+
+    uint32_t head = (uint32_t)SDL_AtomicGet(&thread->Head);
+    uint32_t first = (head > DUI_PROFILE_RING_SIZE ? head - DUI_PROFILE_RING_SIZE : 0);
+    size_t count = head - first;
+
+    for (uint32_t i = first; i != head; ++i) {
+        _duiProfileCopy[i - first] = thread->Events[i & (DUI_PROFILE_RING_SIZE - 1)];
+    }
+
+    // Writing the event at latest reuses the slot of latest - DUI_PROFILE_RING_SIZE,
+    //   so only the events after that one are known to be whole
+    uint32_t latest = (uint32_t)SDL_AtomicGet(&thread->Head);
+    size_t lapped = 0;
+    if (latest - first >= DUI_PROFILE_RING_SIZE) {
+        lapped = SDL_min((latest - first) - DUI_PROFILE_RING_SIZE + 1, count);
+    }
+
+    count -= lapped;
+    SDL_memmove(_duiProfileCopy, _duiProfileCopy + lapped, count * sizeof(DUI_ProfileEvent));
+
+    return count;
 }
 
-void DUI_SetColorDefault()
+void DUI_ProfilerPanel(int width, int height, int frames)
 {
-    SDL_SetRenderDrawColor(_duiRenderer, 
-        _duiStyle.ColorDefault[0],
-        _duiStyle.ColorDefault[1],
-        _duiStyle.ColorDefault[2],
-        _duiStyle.ColorDefault[3]);
+    DUI_PanelStart("PROFILER", width, height, true);
+
+    int available = (int)SDL_min(_duiProfileFrameCount, DUI_PROFILE_MAX_FRAMES) - 1;
+    frames = SDL_min(frames, available);
+
+    if (frames <= 0) {
+        DUI_Println("NO FRAMES RECORDED");
+        DUI_PanelEnd();
+        return;
+    }
+
+    // The current frame is still being recorded, so the timeline ends where it began
+    uint64_t end = _duiProfileFrames[(_duiProfileFrameCount - 1) % DUI_PROFILE_MAX_FRAMES];
+    uint64_t start = _duiProfileFrames[(_duiProfileFrameCount - 1 - frames) % DUI_PROFILE_MAX_FRAMES];
+    uint64_t duration = SDL_max(end - start, 1);
+
+    double msPerTick = 1000.0 / SDL_GetPerformanceFrequency();
+
+    SDL_Point origin = _duiCursor;
+
+    DUI_Println("%d FRAMES, %.2f MS", frames, duration * msPerTick);
+
+    int rowHeight = _duiStyle.CharHeight + _duiStyle.ButtonPadding;
+
+    SDL_Rect area = {
+        .x = origin.x,
+        .y = _duiCursor.y,
+        .w = width,
+        .h = height - (_duiCursor.y - origin.y) - rowHeight,
+    };
+
+    // Frame boundaries
+    DUI_SetColorBorder();
+    for (int i = 0; i <= frames; ++i) {
+        uint64_t time = _duiProfileFrames[(_duiProfileFrameCount - 1 - i) % DUI_PROFILE_MAX_FRAMES];
+        SDL_Rect line = {
+            .x = area.x + (int)(((time - start) * area.w) / duration),
+            .y = area.y,
+            .w = 1,
+            .h = area.h,
+        };
+        DUI_fillRect(&line);
+    }
+
+    DUI_ProfileEvent hovered = { .Name = NULL };
+
+    int threadCount = SDL_min(SDL_AtomicGet(&_duiProfileThreadCount), DUI_PROFILE_MAX_THREADS);
+    int laneY = area.y;
+
+    for (int t = 0; t < threadCount && laneY + rowHeight <= area.y + area.h; ++t) {
+        size_t count = DUI_copyProfileEvents(&_duiProfileThreads[t]);
+        int maxDepth = -1;
+
+        for (size_t i = 0; i < count; ++i) {
+            const DUI_ProfileEvent * event = &_duiProfileCopy[i];
+
+            const char * name = event->Name;
+            if (!name) {
+                continue;
+            }
+
+            uint64_t eventEnd = (event->End ? event->End : end);
+            if (eventEnd <= start || event->Start >= end) {
+                continue;
+            }
+
+            int y = laneY + (event->Depth * rowHeight);
+            if (y + rowHeight > area.y + area.h) {
+                continue;
+            }
+
+            uint64_t x0 = (event->Start > start ? event->Start - start : 0);
+            uint64_t x1 = SDL_min(eventEnd, end) - start;
+
+            SDL_Rect bar = {
+                .x = area.x + (int)((x0 * area.w) / duration),
+                .y = y,
+                .w = SDL_max((int)(((x1 - x0) * area.w) / duration), 1),
+                .h = rowHeight - 1,
+            };
+
+            DUI_setDrawColor(DUI_getNameColor(name));
+            DUI_fillRect(&bar);
+
+            size_t length = DUI_countCharacters(name, strlen(name));
+            if ((int)length * _duiStyle.CharWidth + 2 <= bar.w) {
+                DUI_PrintAt(bar.x + 1, bar.y + (_duiStyle.ButtonPadding / 2), "%s", name);
+            }
+
+            if (SDL_PointInRect(&_duiMouse, &bar)) {
+                hovered = *event;
+            }
+
+            maxDepth = SDL_max(maxDepth, event->Depth);
+        }
+
+        laneY += (maxDepth + 1) * rowHeight + _duiStyle.LinePadding;
+    }
+
+    DUI_MoveCursor(origin.x, area.y + area.h + (_duiStyle.ButtonPadding / 2));
+
+    if (hovered.Name) {
+        uint64_t hoveredEnd = (hovered.End ? hovered.End : end);
+        DUI_Print("%s: %.3f MS", hovered.Name, (hoveredEnd - hovered.Start) * msPerTick);
+    }
+
+    DUI_PanelEnd();
 }
 
-void DUI_MoveCursor(int x, int y)
+void DUI_flushTrace(DUI_TraceDump * dump)
 {
-    _duiCursor.x = x;
-    _duiCursor.y = y;
-    _duiLineStart = _duiCursor.x;
+    SDL_RWwrite(dump->File, dump->Buffer, 1, dump->Length);
+    dump->Length = 0;
 }
 
-void DUI_MoveCursorRelative(int dx, int dy)
+void DUI_writeTrace(DUI_TraceDump * dump, const char * format, ...)
 {
-    _duiCursor.x += dx;
-    _duiCursor.y += dy;
-    _duiLineStart = _duiCursor.x;
+    // Leave room for the longest thing written at once
+    if (dump->Length + 512 > sizeof(dump->Buffer)) {
+        DUI_flushTrace(dump);
+    }
+
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(dump->Buffer + dump->Length, sizeof(dump->Buffer) - dump->Length, format, args);
+    va_end(args);
+
+    if (length > 0) {
+        dump->Length += SDL_min((size_t)length, sizeof(dump->Buffer) - dump->Length - 1);
+    }
 }
 
-void DUI_GetCursor(int * x, int * y)
+// Write a string in quotes, escaping the characters JSON requires
+void DUI_writeTraceString(DUI_TraceDump * dump, const char * text)
 {
-    *x = _duiCursor.x;
-    *y = _duiCursor.y;
+    DUI_writeTrace(dump, "\"");
+
+    for (; *text; ++text) {
+        if (dump->Length + 8 > sizeof(dump->Buffer)) {
+            DUI_flushTrace(dump);
+        }
+
+        unsigned char c = (unsigned char)*text;
+        if (c == '"' || c == '\\') {
+            dump->Buffer[dump->Length++] = '\\';
+            dump->Buffer[dump->Length++] = (char)c;
+        }
+        else if (c < 0x20) {
+            dump->Length += (size_t)snprintf(dump->Buffer + dump->Length, 8, "\\u%04x", c);
+        }
+        else {
+            dump->Buffer[dump->Length++] = (char)c;
+        }
+    }
+
+    DUI_writeTrace(dump, "\"");
 }
 
-void DUI_Newline()
+int DUI_writeTraceThread(void * data)
 {
-    _duiCursor.y += _duiStyle.CharHeight + _duiStyle.LinePadding;
-    _duiCursor.x = _duiLineStart;
+    DUI_TraceDump * dump = data;
 
-    DUI_growPanel();
+    double usPerTick = 1000000.0 / SDL_GetPerformanceFrequency();
+
+    DUI_writeTrace(dump, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    DUI_writeTrace(dump, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"DUI\"}}");
+
+    for (int i = 0; i < dump->FrameCount; ++i) {
+        DUI_writeTrace(dump, ",\n{\"name\":\"FRAME\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":0,\"ts\":%.3f}",
+            (dump->Frames[i] - dump->Origin) * usPerTick);
+    }
+
+    for (size_t i = 0; i < dump->EventCount; ++i) {
+        const DUI_TraceEvent * event = &dump->Events[i];
+
+        DUI_writeTrace(dump, ",\n{\"name\":");
+        DUI_writeTraceString(dump, event->Name);
+        DUI_writeTrace(dump, ",\"ph\":\"X\",\"pid\":1,\"tid\":%lu,\"ts\":%.3f,\"dur\":%.3f}",
+            (unsigned long)event->ThreadID,
+            (event->Start - dump->Origin) * usPerTick,
+            (event->End - event->Start) * usPerTick);
+    }
+
+    DUI_writeTrace(dump, "\n]}\n");
+    DUI_flushTrace(dump);
+
+    SDL_RWclose(dump->File);
+    dump->File = NULL;
+
+    SDL_AtomicSet(&_duiProfileDumpBusy, 0);
+    return 0;
 }
 
-void DUI_Print(const char * format, ...)
+bool DUI_ProfilerDump(const char * path)
 {
-    static char buffer[1024];
+    if (!SDL_AtomicCAS(&_duiProfileDumpBusy, 0, 1)) {
+        return false;
+    }
 
-    va_list args;
-    va_start(args, format);
-    vsnprintf(buffer, sizeof(buffer), format, args);
-    va_end(args);
+    // The previous dump has finished, but its thread still needs to be cleaned up
+    if (_duiProfileDumpThread) {
+        SDL_WaitThread(_duiProfileDumpThread, NULL);
+        _duiProfileDumpThread = NULL;
+    }
 
-    size_t length = strlen(buffer);
+    int threadCount = SDL_min(SDL_AtomicGet(&_duiProfileThreadCount), DUI_PROFILE_MAX_THREADS);
 
-    SDL_Rect src = { 
-        .x = 0,
-        .y = 0,
-        .w = DUI_FONT_CHAR_WIDTH,
-        .h = DUI_FONT_CHAR_HEIGHT,
-    };
+    if (!_duiProfileDump) {
+        _duiProfileDump = SDL_calloc(1, sizeof(DUI_TraceDump));
+    }
 
-    SDL_Rect dst = { 
-        .x = _duiCursor.x,
-        .y = _duiCursor.y,
-        .w = _duiStyle.CharWidth,
-        .h = _duiStyle.CharHeight,
-    };
+    DUI_TraceDump * dump = _duiProfileDump;
 
-    int charPerLine = (DUI_FONT_MAP_WIDTH / DUI_FONT_CHAR_WIDTH);
+    if (!dump || !DUI_reserve((void **)&dump->Events, &dump->EventCapacity, 
+            (size_t)threadCount * DUI_PROFILE_RING_SIZE, sizeof(DUI_TraceEvent))) {
+        SDL_AtomicSet(&_duiProfileDumpBusy, 0);
+        return false;
+    }
 
-    char * questionMark = strchr(DUI_FONT_MAP, '?');
+    dump->File = SDL_RWFromFile(path, "wb");
+    if (!dump->File) {
+        SDL_AtomicSet(&_duiProfileDumpBusy, 0);
+        return false;
+    }
 
-    for (size_t i = 0; i < length; ++i) {
-        if (buffer[i] == ' ') {
-            dst.x += _duiStyle.CharWidth;
-            continue;
-        }
+    DUI_TraceEvent * events = dump->Events;
+    dump->EventCount = 0;
+    dump->Length = 0;
 
-        if (buffer[i] == '\n') {
-            DUI_Newline();
-            dst.x = _duiCursor.x;
-            dst.y = _duiCursor.y;
-            continue;
-        }
+    uint64_t now = SDL_GetPerformanceCounter();
+    dump->Origin = now;
 
-        char search = buffer[i];
-        if (DUI_FONT_UPPERCASE) {
-            search = toupper(buffer[i]);
-        }
+    for (int t = 0; t < threadCount; ++t) {
+        DUI_ProfileThread * thread = &_duiProfileThreads[t];
+        size_t count = DUI_copyProfileEvents(thread);
 
-        char * index = strchr(DUI_FONT_MAP, search);
+        for (size_t i = 0; i < count; ++i) {
+            const DUI_ProfileEvent * event = &_duiProfileCopy[i];
+            if (!event->Name) {
+                continue;
+            }
 
-        if (index == NULL) {
-            index = questionMark;
-        }
+            uint64_t end = (event->End ? event->End : now);
+            if (end < event->Start) {
+                continue;
+            }
 
-        size_t offset = index - DUI_FONT_MAP;
+            events[dump->EventCount++] = (DUI_TraceEvent){
+                .Name = event->Name,
+                .Start = event->Start,
+                .End = end,
+                .ThreadID = thread->ThreadID,
+            };
+
+            dump->Origin = SDL_min(dump->Origin, event->Start);
+        }
+    }
 
-        src.x = (offset % charPerLine) * DUI_FONT_CHAR_WIDTH;
-        src.y = (offset / charPerLine) * DUI_FONT_CHAR_HEIGHT;
-        SDL_RenderCopy(_duiRenderer, _duiFontTexture, &src, &dst);
+    dump->FrameCount = (int)SDL_min(_duiProfileFrameCount, DUI_PROFILE_MAX_FRAMES);
+    for (int i = 0; i < dump->FrameCount; ++i) {
+        dump->Frames[i] = _duiProfileFrames[(_duiProfileFrameCount - dump->FrameCount + i) % DUI_PROFILE_MAX_FRAMES];
+    }
 
-        dst.x += _duiStyle.CharWidth;
+    if (dump->FrameCount > 0) {
+        dump->Origin = SDL_min(dump->Origin, dump->Frames[0]);
     }
 
-    _duiCursor.x = dst.x;
-    _duiCursor.y = dst.y;
+    _duiProfileDumpThread = SDL_CreateThread(DUI_writeTraceThread, "DUI_ProfilerDump", dump);
+    if (!_duiProfileDumpThread) {
+        DUI_writeTraceThread(dump);
+    }
 
-    DUI_growPanel();
+    return true;
 }
 
-void DUI_PanelStart(const char * title, int width, int height, bool fixed)
+bool DUI_ChannelPush(uint32_t id, float value)
 {
-    DUI_PanelInfo * panel = DUI_pushPanel();
-    panel->Fixed = fixed;
-    panel->Title = title;
-    panel->Bounds.x = _duiCursor.x;
-    panel->Bounds.y = _duiCursor.y;
-    panel->Bounds.w = width + _duiStyle.PanelPadding;
-    panel->Bounds.h = height + _duiStyle.PanelPadding;
+    DUI_ChannelQueue * queue = DUI_getChannelQueue();
+    if (!queue) {
+        return false;
+    }
 
-    if (panel->Title) {
-        panel->Bounds.y += (_duiStyle.CharHeight / 2);
-        DUI_MoveCursorRelative(0, _duiStyle.CharHeight);
+    uint32_t head = (uint32_t)SDL_AtomicGet(&queue->Head);
+
+    // Don't overwrite records before DUI_Update has finished reading them
+    uint32_t tail = (uint32_t)SDL_AtomicGet(&queue->Tail);
+
+    if (head - tail >= DUI_CHANNEL_QUEUE_SIZE) {
+        SDL_AtomicAdd(&queue->Dropped, 1);
+        return false;
     }
 
-    DUI_MoveCursorRelative(_duiStyle.PanelPadding, _duiStyle.PanelPadding);
+    queue->Records[head & (DUI_CHANNEL_QUEUE_SIZE - 1)] = (DUI_ChannelRecord){
+        .ID = id,
+        .Value = value,
+        .Timestamp = SDL_GetPerformanceCounter(),
+    };
 
-    SDL_SetRenderTarget(_duiRenderer, _duiPanelStack[_duiPanelStackIndex].Texture);
-    SDL_SetRenderDrawColor(_duiRenderer, 0x00, 0x00, 0x00, 0x00);
-    SDL_RenderClear(_duiRenderer);
+    SDL_AtomicSet(&queue->Head, (int)(head + 1));
+    return true;
 }
 
-void DUI_PanelEnd()
+bool DUI_ChannelBind(uint32_t id, DUI_Series * series)
 {
-    DUI_PanelInfo * panel = DUI_getCurrentPanel();
+    DUI_ChannelBinding * binding = DUI_findChannelBinding(id);
+    if (!binding) {
+        return false;
+    }
 
-    panel->Bounds.w += _duiStyle.PanelPadding;
-    panel->Bounds.h += _duiStyle.PanelPadding;
+    if (!binding->Bound) {
+        // Keep at least one slot empty, so lookups of unbound IDs end
+        if (_duiChannelBindingCount + 1 >= DUI_CHANNEL_MAX_BINDINGS) {
+            return false;
+        }
 
-    SDL_Rect bounds = panel->Bounds;
+        *binding = (DUI_ChannelBinding){ .Bound = true, .ID = id };
+        ++_duiChannelBindingCount;
+    }
 
-    if (panel->Title) {
-        SDL_Rect bounds = panel->Bounds;
-        bounds.x += _duiStyle.CharWidth;
-        bounds.y -= (_duiStyle.CharHeight / 2);
-        bounds.w = (_duiStyle.CharWidth * (strlen(panel->Title) + 2));
-        bounds.h = _duiStyle.CharHeight;
-        
-        DUI_SetColorBackground();
-        SDL_RenderFillRect(_duiRenderer, &bounds);
+    binding->Series = series;
+    return true;
+}
 
-        DUI_PrintAt(bounds.x + _duiStyle.CharWidth, bounds.y, panel->Title);
+bool DUI_ChannelLatest(uint32_t id, float * value, uint64_t * timestamp)
+{
+    DUI_ChannelBinding * binding = DUI_findChannelBinding(id);
+    if (!binding || !binding->Bound || !binding->HasValue) {
+        return false;
     }
 
-    SDL_SetRenderTarget(_duiRenderer, _duiPanelStack[_duiPanelStackIndex - 1].Texture);
-
-    DUI_SetColorBackground();
-    SDL_RenderFillRect(_duiRenderer, &bounds);
+    *value = binding->Value;
+    if (timestamp) {
+        *timestamp = binding->Timestamp;
+    }
 
-    DUI_SetColorBorder();
-    SDL_RenderDrawRect(_duiRenderer, &bounds);
+    return true;
+}
 
-    SDL_RenderCopy(_duiRenderer, _duiPanelStack[_duiPanelStackIndex].Texture, NULL, NULL);
+uint32_t DUI_ChannelDropped()
+{
+    uint32_t dropped = 0;
 
-    DUI_MoveCursor(panel->Bounds.x, 
-        panel->Bounds.y + panel->Bounds.h + _duiStyle.LinePadding);
+    int queueCount = SDL_min(SDL_AtomicGet(&_duiChannelQueueCount), DUI_CHANNEL_MAX_THREADS);
+    for (int i = 0; i < queueCount; ++i) {
+        dropped += (uint32_t)SDL_AtomicGet(&_duiChannelQueues[i].Dropped);
+    }
 
-    DUI_popPanel();
+    return dropped;
 }
 
-bool DUI_Button(const char * text)
-{
-    int width = (strlen(text) * _duiStyle.CharWidth) 
-        + (_duiStyle.ButtonPadding * 2);
+#ifndef DUI_CONSOLE_SCROLL_LINES
+#   define DUI_CONSOLE_SCROLL_LINES (3)
+#endif // DUI_CONSOLE_SCROLL_LINES
 
-    int height = _duiStyle.CharHeight
-        + (_duiStyle.ButtonPadding * 2);
+typedef struct
+{
+    // The position of the text in the console's text, modulo TextSize
+    uint64_t Offset;
+    size_t Length;
 
-    SDL_Rect bounds = {
-        .x = _duiCursor.x,
-        .y = _duiCursor.y,
-        .w = width,
-        .h = height,
-    };
+} DUI_ConsoleLine;
 
-    bool hover = SDL_PointInRect(&_duiMouse, &bounds);
-    bool clicked = (hover && _duiClicked);
+struct DUI_Console
+{
+    // Each line is stored contiguously, skipping to the start when it
+    //   would not fit before the end
+    char * Text;
+    size_t TextSize;
 
-    if (hover) {
-        DUI_SetColorHover();
-    }
-    else {
-        DUI_SetColorDefault();
-    }
+    // The number of bytes ever written, including those skipped
+    uint64_t TextEnd;
 
-    SDL_RenderFillRect(_duiRenderer, &bounds);
+    // Indexed by their position modulo LineCapacity
+    DUI_ConsoleLine * Lines;
+    size_t LineCapacity;
 
-    DUI_SetColorBorder();
-    SDL_RenderDrawRect(_duiRenderer, &bounds);
+    // The index of the oldest line kept, and the number of lines ever appended
+    uint64_t First;
+    uint64_t Total;
 
-    _duiCursor.x += _duiStyle.ButtonPadding;
-    _duiCursor.y += _duiStyle.ButtonPadding;
+    // The index of the first line drawn, while not following new lines
+    uint64_t Top;
+    bool Follow;
 
-    DUI_Print("%s", text);
+};
 
-    _duiCursor.x = bounds.x + bounds.w + _duiStyle.ButtonMargin;
-    _duiCursor.y = bounds.y;
+size_t DUI_roundUpPowerOfTwo(size_t value)
+{
+    size_t result = 1;
+    while (result < value) {
+        result *= 2;
+    }
 
-    return clicked;
+    return result;
 }
 
-bool DUI_ButtonAt(int x, int y, const char * text)
+DUI_Console * DUI_CreateConsole(size_t lines, size_t bytes)
 {
-    SDL_Point tmp = _duiCursor;
-    _duiCursor.x = x;
-    _duiCursor.y = y;
+    size_t lineCapacity = DUI_roundUpPowerOfTwo(SDL_max(lines, 1));
+    size_t textSize = DUI_roundUpPowerOfTwo(SDL_max(bytes, 1));
 
-    bool clicked = DUI_Button(text);
+    DUI_Console * console = SDL_malloc(sizeof(DUI_Console) 
+        + (lineCapacity * sizeof(DUI_ConsoleLine)) 
+        + textSize);
 
-    _duiCursor = tmp;
+    if (!console) {
+        return NULL;
+    }
 
-    return clicked;
+    *console = (DUI_Console){
+        .Lines = (DUI_ConsoleLine *)(console + 1),
+        .LineCapacity = lineCapacity,
+        .Text = (char *)((DUI_ConsoleLine *)(console + 1) + lineCapacity),
+        .TextSize = textSize,
+        .Follow = true,
+    };
+
+    return console;
 }
 
-bool DUI_Checkbox(const char * text, bool * checked)
+void DUI_DestroyConsole(DUI_Console * console)
 {
-    int width = (strlen(text) * _duiStyle.CharWidth)
-        + (_duiStyle.CharWidth * 2)
-        + (_duiStyle.ButtonPadding * 2);
-
-    int height = _duiStyle.CharHeight
-        + (_duiStyle.ButtonPadding * 2);
+    SDL_free(console);
+}
 
-    SDL_Rect bounds = {
-        .x = _duiCursor.x,
-        .y = _duiCursor.y,
-        .w = width,
-        .h = height,
-    };
+void DUI_appendConsoleLine(DUI_Console * console, const char * text, size_t length)
+{
+    length = SDL_min(length, console->TextSize);
 
-    bool hover = SDL_PointInRect(&_duiMouse, &bounds);
-    bool clicked = (hover && _duiClicked);
+    uint64_t offset = console->TextEnd;
+    size_t start = (size_t)(offset & (console->TextSize - 1));
 
-    if (hover) {
-        DUI_SetColorHover();
-    }
-    else {
-        DUI_SetColorDefault();
+    if (start + length > console->TextSize) {
+        offset += console->TextSize - start;
+        start = 0;
     }
 
-    SDL_RenderFillRect(_duiRenderer, &bounds);
+    SDL_memcpy(console->Text + start, text, length);
+    console->TextEnd = offset + length;
 
-    DUI_SetColorBorder();
-    SDL_RenderDrawRect(_duiRenderer, &bounds);
+    if (console->Total - console->First == console->LineCapacity) {
+        ++console->First;
+    }
 
-    SDL_Rect mark = { 
-        .x = bounds.x + (_duiStyle.CharWidth / 2),
-        .y = bounds.y + (_duiStyle.CharHeight / 2),
-        .w = _duiStyle.CharWidth,
-        .h = _duiStyle.CharWidth,
+    console->Lines[console->Total & (console->LineCapacity - 1)] = (DUI_ConsoleLine){
+        .Offset = offset,
+        .Length = length,
     };
+    ++console->Total;
 
-    SDL_RenderDrawRect(_duiRenderer, &mark);
+    // Discard the lines whose text was just overwritten
+    if (console->TextEnd > console->TextSize) {
+        uint64_t oldest = console->TextEnd - console->TextSize;
 
-    if (clicked) {
-        *checked ^= true;
+        while (console->Lines[console->First & (console->LineCapacity - 1)].Offset < oldest) {
+            ++console->First;
+        }
     }
+}
 
-    if (*checked) {
-        ++mark.x;
-        ++mark.y;
-        mark.w -= 2;
-        mark.h -= 2;
-
-        SDL_RenderFillRect(_duiRenderer, &mark);
-    }
+void DUI_ConsoleAppend(DUI_Console * console, const char * text)
+{
+    size_t length = strlen(text);
 
-    _duiCursor.x += _duiStyle.ButtonPadding
-        + _duiStyle.CharWidth
-        + (_duiStyle.CharWidth / 2);
-    _duiCursor.y += _duiStyle.ButtonPadding;
+    for (;;) {
+        const char * newline = memchr(text, '\n', length);
+        if (!newline) {
+            break;
+        }
 
-    DUI_Print("%s", text);
+        DUI_appendConsoleLine(console, text, (size_t)(newline - text));
+        length -= (size_t)(newline - text) + 1;
+        text = newline + 1;
 
-    _duiCursor.x = bounds.x + bounds.w + _duiStyle.ButtonMargin;
-    _duiCursor.y = bounds.y;
+        // A trailing newline ends the last line instead of starting an empty one
+        if (length == 0) {
+            return;
+        }
+    }
 
-    return *checked;
+    DUI_appendConsoleLine(console, text, length);
 }
 
-bool DUI_CheckboxAt(int x, int y, const char * text, bool * checked)
+void DUI_ConsolePrint(DUI_Console * console, const char * format, ...)
 {
-    SDL_Point tmp = _duiCursor;
-    _duiCursor.x = x;
-    _duiCursor.y = y;
+    char buffer[1024];
 
-    bool selected = DUI_Checkbox(text, checked);
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
 
-    _duiCursor = tmp;
+    DUI_ConsoleAppend(console, buffer);
+}
 
-    return selected;
+void DUI_ConsoleClear(DUI_Console * console)
+{
+    console->First = console->Total;
+    console->Top = console->Total;
+    console->Follow = true;
 }
 
-bool DUI_Radio(const char * text, int index, int * currentIndex)
+size_t DUI_ConsoleCount(const DUI_Console * console)
 {
-    int width = (strlen(text) * _duiStyle.CharWidth) 
-        + (_duiStyle.CharWidth * 2)
-        + (_duiStyle.ButtonPadding * 2);
+    return (size_t)(console->Total - console->First);
+}
 
-    int height = _duiStyle.CharHeight 
-        + (_duiStyle.ButtonPadding * 2);
+void DUI_ConsolePanel(DUI_Console * console, int width, int height)
+{
+    ++_duiStatsFrame.Widgets;
 
     SDL_Rect bounds = {
         .x = _duiCursor.x,
@@ -855,125 +6838,198 @@ bool DUI_Radio(const char * text, int index, int * currentIndex)
         .h = height,
     };
 
-    bool hover = SDL_PointInRect(&_duiMouse, &bounds);
-    bool clicked = (hover && _duiClicked);
+    DUI_SetColorBackground();
+    DUI_fillRect(&bounds);
 
-    if (clicked) {
-        *currentIndex = index;
-    }
+    DUI_SetColorBorder();
+    DUI_drawRect(&bounds);
 
-    bool active = (*currentIndex == index);
+    int padding = _duiStyle.ButtonPadding;
+    int lineHeight = _duiStyle.CharHeight + _duiStyle.LinePadding;
 
-    if (hover) {
-        DUI_SetColorHover();
+    SDL_Rect track = {
+        .x = bounds.x + bounds.w - 1 - _duiStyle.CharWidth,
+        .y = bounds.y + 1,
+        .w = _duiStyle.CharWidth,
+        .h = bounds.h - 2,
+    };
+
+    int textWidth = track.x - (bounds.x + padding);
+    size_t columns = (size_t)SDL_max(textWidth / _duiStyle.CharWidth, 0);
+    uint64_t visible = (uint64_t)SDL_max((bounds.h - (padding * 2) + _duiStyle.LinePadding) / lineHeight, 0);
+
+    uint64_t count = console->Total - console->First;
+    uint64_t bottom = SDL_max(console->First, console->Total - SDL_min(visible, count));
+
+    if (console->Follow) {
+        console->Top = bottom;
     }
-    else {
-        DUI_SetColorDefault();
+
+    if (_duiWheel != 0 && SDL_PointInRect(&_duiMouse, &bounds)) {
+        int64_t lines = (int64_t)_duiWheel * DUI_CONSOLE_SCROLL_LINES;
+        _duiWheel = 0;
+
+        if (lines > 0) {
+            console->Top -= SDL_min((uint64_t)lines, console->Top - console->First);
+        }
+        else {
+            console->Top += (uint64_t)-lines;
+        }
     }
 
-    SDL_RenderFillRect(_duiRenderer, &bounds);
+    int thumbHeight = track.h;
+    if (count > visible) {
+        thumbHeight = SDL_max((int)((track.h * visible) / count), _duiStyle.CharHeight);
+    }
 
-    DUI_SetColorBorder();
-    SDL_RenderDrawRect(_duiRenderer, &bounds);
+    int travel = track.h - thumbHeight;
 
-    SDL_Rect mark = { 
-        .x = bounds.x + (_duiStyle.CharWidth / 2),
-        .y = bounds.y + (_duiStyle.CharHeight / 2),
-        .w = _duiStyle.CharWidth, 
-        .h = _duiStyle.CharWidth
-    };
+    if (_duiMouseDown && count > visible && travel > 0 && SDL_PointInRect(&_duiMouse, &track)) {
+        int y = SDL_max(0, SDL_min(_duiMouse.y - track.y - (thumbHeight / 2), travel));
+        console->Top = console->First + (((count - visible) * (uint64_t)y) / (uint64_t)travel);
+    }
 
-    SDL_RenderDrawRect(_duiRenderer, &mark);
+    // Lines may have been discarded since the last frame
+    console->Top = SDL_max(console->Top, console->First);
+    console->Top = SDL_min(console->Top, bottom);
+    console->Follow = (console->Top == bottom);
 
-    if (active) {
-        ++mark.x;
-        ++mark.y;
-        mark.w -= 2;
-        mark.h -= 2;
+    if (count > visible) {
+        SDL_Rect thumb = {
+            .x = track.x,
+            .y = track.y + (int)((travel * (console->Top - console->First)) / (count - visible)),
+            .w = track.w,
+            .h = thumbHeight,
+        };
 
-        SDL_RenderFillRect(_duiRenderer, &mark);
+        DUI_SetColorDefault();
+        DUI_fillRect(&thumb);
     }
 
-    _duiCursor.x += _duiStyle.ButtonPadding
-        + _duiStyle.CharWidth
-        + (_duiStyle.CharWidth / 2);
-    _duiCursor.y += _duiStyle.ButtonPadding;
-    
-    DUI_Print("%s", text);
+    DUI_SetColorBorder();
+    DUI_drawRect(&track);
 
-    _duiCursor.x = bounds.x + bounds.w + _duiStyle.ButtonMargin;
-    _duiCursor.y = bounds.y;
+    uint64_t end = SDL_min(console->Top + visible, console->Total);
 
-    return active;
+    for (uint64_t i = console->Top; i < end; ++i) {
+        const DUI_ConsoleLine * line = &console->Lines[i & (console->LineCapacity - 1)];
+        const char * text = console->Text + (line->Offset & (console->TextSize - 1));
+
+        _duiCursor.x = bounds.x + padding;
+        _duiCursor.y = bounds.y + padding + (int)((i - console->Top) * (uint64_t)lineHeight);
+        DUI_pushText(text, DUI_characterPrefix(text, line->Length, columns));
+    }
+
+    _duiCursor.x = bounds.x + bounds.w;
+    _duiCursor.y = bounds.y + bounds.h;
+    DUI_growPanel();
+
+    _duiCursor.x = _duiLineStart;
+    _duiCursor.y += _duiStyle.LinePadding;
 }
 
-bool DUI_RadioAt(int x, int y, const char * text, int index, int * currentIndex)
+#if defined(DUI_TRUETYPE)
+
+// Load a font to be rasterized at pixelHeight, with distances kept spread
+//   pixels from the outline, or coverage if spread is 0
+bool DUI_openFont(const char * path, int pixelHeight, int spread, const char * cachePath)
 {
-    SDL_Point tmp = _duiCursor;
-    _duiCursor.x = x;
-    _duiCursor.y = y;
+    DUI_writeFontCache();
+    DUI_freeFont();
+    _duiRetainedValid = false;
 
-    bool selected = DUI_Radio(text, index, currentIndex);
+    DUI_Font * font = &_duiFont;
 
-    _duiCursor = tmp;
+    size_t size = 0;
+    font->Data = SDL_LoadFile(path, &size);
+    if (!font->Data) {
+        return false;
+    }
 
-    return selected;
-}
+    font->Baked = SDL_calloc(0x110000 / 32, sizeof(uint32_t));
 
-void DUI_BeginTabBar()
-{
-    _duiTabCursor = _duiCursor;
+    if (!font->Baked || !DUI_ttInit(&font->TT, font->Data, size)) {
+        DUI_freeFont();
+        return false;
+    }
+
+    font->Hash = DUI_hash(font->Data, size, 0);
+    font->PixelHeight = pixelHeight;
+    font->Spread = spread;
+    font->Scale = (float)pixelHeight / (font->TT.Ascender - font->TT.Descender);
+    font->Baseline = (int)SDL_floorf((font->TT.Ascender * font->Scale) + 0.5f);
+
+    int advance = DUI_ttGetAdvance(&font->TT, DUI_ttFindGlyph(&font->TT, ' '));
+    font->CellWidth = SDL_max((int)SDL_floorf((advance * font->Scale) + 0.5f), 1);
+
+    if (cachePath) {
+        font->CachePath = SDL_strdup(cachePath);
+    }
+
+    return true;
 }
 
-bool DUI_Tab(const char * text, int index, int * currentIndex)
+bool DUI_LoadFont(const char * path, int pixelHeight, const char * cachePath)
 {
-    _duiCursor = _duiTabCursor;
+    if (pixelHeight <= 0 || !DUI_openFont(path, pixelHeight, 0, cachePath)) {
+        return false;
+    }
 
-    int width = (strlen(text) * _duiStyle.CharWidth) 
-        + (_duiStyle.TabPadding * 2);
+    DUI_Font * font = &_duiFont;
+    DUI_buildFontRamp(&font->Ramps[0], pixelHeight);
+    font->RampCount = 1;
 
-    int height = _duiStyle.CharHeight
-        + (_duiStyle.TabPadding * 2);
+    if (font->CachePath) {
+        DUI_readFontCache(font->CachePath);
+    }
 
-    SDL_Rect bounds = {
-        .x = _duiCursor.x,
-        .y = _duiCursor.y,
-        .w = width,
-        .h = height,
-    };
+    DUI_keepUserGlyphs();
 
-    bool hover = SDL_PointInRect(&_duiMouse, &bounds);
-    bool clicked = (hover && _duiClicked);
+    // ASCII is drawn without looking up glyphs, so it is rasterized now,
+    //   starting with the glyph used for missing characters
+    if (!DUI_isFontGlyphBaked('?')) {
+        DUI_bakeFontGlyph('?');
+    }
 
-    if (clicked) {
-        *currentIndex = index;
+    for (uint32_t c = 0; c < 0x80; ++c) {
+        if (!DUI_isFontGlyphBaked(c)) {
+            DUI_bakeFontGlyph(c);
+        }
     }
 
-    bool active = (*currentIndex == index);
+    _duiStyle.CharWidth = font->CellWidth;
+    _duiStyle.CharHeight = pixelHeight;
 
-    if (hover || active) {
-        DUI_SetColorHover();
-    }
-    else {
-        DUI_SetColorDefault();
+    return true;
+}
+
+bool DUI_LoadFontSDF(const char * path, int pixelHeight, const char * cachePath)
+{
+    if (pixelHeight <= 0 
+        || !DUI_openFont(path, DUI_FONT_SDF_SIZE, DUI_FONT_SDF_SPREAD, cachePath)) {
+        return false;
     }
 
-    SDL_RenderFillRect(_duiRenderer, &bounds);
+    DUI_Font * font = &_duiFont;
+    DUI_buildFontRamp(&font->Ramps[0], pixelHeight);
+    font->RampCount = 1;
 
-    DUI_SetColorBorder();
-    SDL_RenderDrawRect(_duiRenderer, &bounds);
+    if (!font->CachePath || !DUI_readFontCache(font->CachePath)) {
+        DUI_generateFontSDF();
+    }
 
-    _duiCursor.x += _duiStyle.TabPadding;
-    _duiCursor.y += _duiStyle.TabPadding;
-    
-    DUI_Print("%s", text);
+    // Every glyph is in the atlas, so nothing is rasterized on demand
+    SDL_memset(font->Baked, 0xFF, (0x110000 / 32) * sizeof(uint32_t));
 
-    _duiCursor.x = bounds.x + bounds.w + _duiStyle.TabMargin;
-    _duiCursor.y = bounds.y;
+    DUI_keepUserGlyphs();
 
-    _duiTabCursor = _duiCursor;
+    float scale = (float)pixelHeight / font->PixelHeight;
+    _duiStyle.CharWidth = SDL_max((int)SDL_floorf((font->CellWidth * scale) + 0.5f), 1);
+    _duiStyle.CharHeight = pixelHeight;
 
-    return active;
+    return true;
 }
 
+#endif // DUI_TRUETYPE
+
 #endif
\ No newline at end of file
@@ -0,0 +1,989 @@
+/*
+Copyright 2020 Stephen Lane-Walsh
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// A minimal TrueType reader and rasterizer, included by DUI.h when
+//   DUI_TRUETYPE is defined. It supports the cmap, glyf and hmtx tables,
+//   which is enough to draw outlines from fonts such as Anonymous Pro,
+//   without hinting or kerning. Like DUI.h, the functions are only defined
+//   where DUI_IMPLEMENTATION is.
+
+#ifndef DUI_TRUETYPE_H
+#define DUI_TRUETYPE_H
+
+typedef struct
+{
+    const uint8_t * Data;
+    size_t Size;
+
+    uint32_t Cmap;
+    uint32_t Loca;
+    uint32_t Glyf;
+    uint32_t Hmtx;
+
+    int UnitsPerEm;
+    int Ascender;
+    int Descender;
+
+    int GlyphCount;
+    int HMetricCount;
+    bool LongOffsets;
+
+} DUI_TTFont;
+
+typedef struct
+{
+    // The number of pixels per font unit, and the position of the origin
+    //   in the bitmap
+    float Scale;
+    float OriginX;
+    float OriginY;
+
+    // Coverage accumulated by DUI_ttLine, each row has Width + 2 values
+    float * Accumulator;
+    int Width;
+    int Height;
+
+} DUI_TTRaster;
+
+// Composite glyphs that reference more levels of components are treated as missing
+#define DUI_TT_MAX_COMPONENT_DEPTH (8)
+
+#if defined(DUI_IMPLEMENTATION)
+
+uint16_t DUI_ttU16(const uint8_t * p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+int16_t DUI_ttI16(const uint8_t * p)
+{
+    return (int16_t)DUI_ttU16(p);
+}
+
+uint32_t DUI_ttU32(const uint8_t * p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+// Find a table, and check it fits in the file
+uint32_t DUI_ttFindTable(const DUI_TTFont * font, const char * tag, uint32_t minimumLength)
+{
+    if (font->Size < 12) {
+        return 0;
+    }
+
+    int tableCount = DUI_ttU16(font->Data + 4);
+
+    for (int i = 0; i < tableCount; ++i) {
+        const uint8_t * record = font->Data + 12 + (i * 16);
+        if ((size_t)(record + 16 - font->Data) > font->Size) {
+            return 0;
+        }
+
+        if (SDL_memcmp(record, tag, 4) == 0) {
+            uint32_t offset = DUI_ttU32(record + 8);
+            uint32_t length = DUI_ttU32(record + 12);
+
+            if (length < minimumLength || (size_t)offset + length > font->Size) {
+                return 0;
+            }
+
+            return offset;
+        }
+    }
+
+    return 0;
+}
+
+bool DUI_ttInit(DUI_TTFont * font, const void * data, size_t size)
+{
+    *font = (DUI_TTFont){
+        .Data = data,
+        .Size = size,
+    };
+
+    uint32_t head = DUI_ttFindTable(font, "head", 54);
+    uint32_t maxp = DUI_ttFindTable(font, "maxp", 6);
+    uint32_t hhea = DUI_ttFindTable(font, "hhea", 36);
+    font->Cmap = DUI_ttFindTable(font, "cmap", 4);
+    font->Loca = DUI_ttFindTable(font, "loca", 0);
+    font->Glyf = DUI_ttFindTable(font, "glyf", 0);
+    font->Hmtx = DUI_ttFindTable(font, "hmtx", 4);
+
+    if (!head || !maxp || !hhea || !font->Cmap || !font->Loca || !font->Glyf || !font->Hmtx) {
+        return false;
+    }
+
+    font->UnitsPerEm = DUI_ttU16(font->Data + head + 18);
+    font->LongOffsets = (DUI_ttI16(font->Data + head + 50) != 0);
+    font->GlyphCount = DUI_ttU16(font->Data + maxp + 4);
+    font->Ascender = DUI_ttI16(font->Data + hhea + 4);
+    font->Descender = DUI_ttI16(font->Data + hhea + 6);
+    font->HMetricCount = DUI_ttU16(font->Data + hhea + 34);
+
+    // Every advance width is read from the long metrics at the start of hmtx
+    if (DUI_ttFindTable(font, "hmtx", (uint32_t)font->HMetricCount * 4) == 0) {
+        return false;
+    }
+
+    return (font->UnitsPerEm > 0 && font->HMetricCount > 0
+        && font->Ascender > font->Descender);
+}
+
+// Find the glyph for a codepoint in a format 4 or format 12 cmap subtable
+int DUI_ttLookupSubtable(const DUI_TTFont * font, uint32_t offset, uint32_t codepoint)
+{
+    const uint8_t * table = font->Data + offset;
+    uint16_t format = DUI_ttU16(table);
+
+    if (format == 4) {
+        if (codepoint > 0xFFFF || (size_t)offset + 14 > font->Size) {
+            return 0;
+        }
+
+        int segmentCount = DUI_ttU16(table + 6) / 2;
+        if ((size_t)offset + 16 + (segmentCount * 8) > font->Size) {
+            return 0;
+        }
+
+        const uint8_t * endCodes = table + 14;
+        const uint8_t * startCodes = endCodes + (segmentCount * 2) + 2;
+        const uint8_t * deltas = startCodes + (segmentCount * 2);
+        const uint8_t * rangeOffsets = deltas + (segmentCount * 2);
+
+        // Segments are sorted by their end code
+        int low = 0;
+        int high = segmentCount;
+        while (low < high) {
+            int middle = (low + high) / 2;
+            if (DUI_ttU16(endCodes + (middle * 2)) < codepoint) {
+                low = middle + 1;
+            }
+            else {
+                high = middle;
+            }
+        }
+
+        if (low == segmentCount || DUI_ttU16(startCodes + (low * 2)) > codepoint) {
+            return 0;
+        }
+
+        uint16_t delta = DUI_ttU16(deltas + (low * 2));
+        uint16_t rangeOffset = DUI_ttU16(rangeOffsets + (low * 2));
+
+        if (rangeOffset == 0) {
+            return (uint16_t)(codepoint + delta);
+        }
+
+        const uint8_t * glyph = rangeOffsets + (low * 2) + rangeOffset
+            + ((codepoint - DUI_ttU16(startCodes + (low * 2))) * 2);
+        if ((size_t)(glyph + 2 - font->Data) > font->Size) {
+            return 0;
+        }
+
+        uint16_t index = DUI_ttU16(glyph);
+        return (index ? (uint16_t)(index + delta) : 0);
+    }
+
+    if (format == 12) {
+        if ((size_t)offset + 16 > font->Size) {
+            return 0;
+        }
+
+        uint32_t groupCount = DUI_ttU32(table + 12);
+        if ((size_t)offset + 16 + ((size_t)groupCount * 12) > font->Size) {
+            return 0;
+        }
+
+        uint32_t low = 0;
+        uint32_t high = groupCount;
+        while (low < high) {
+            uint32_t middle = (low + high) / 2;
+            const uint8_t * group = table + 16 + (middle * 12);
+
+            if (codepoint < DUI_ttU32(group)) {
+                high = middle;
+            }
+            else if (codepoint > DUI_ttU32(group + 4)) {
+                low = middle + 1;
+            }
+            else {
+                // Compared before the cast, as a bad group can point past INT_MAX
+                uint32_t glyph = DUI_ttU32(group + 8) + (codepoint - DUI_ttU32(group));
+                return (glyph < (uint32_t)font->GlyphCount ? (int)glyph : 0);
+            }
+        }
+    }
+
+    return 0;
+}
+
+// Find the offset of the cmap subtable to use, 0 if there are none supported
+uint32_t DUI_ttFindSubtable(const DUI_TTFont * font)
+{
+    const uint8_t * cmap = font->Data + font->Cmap;
+    int subtableCount = DUI_ttU16(cmap + 2);
+
+    uint32_t best = 0;
+    int bestRank = 0;
+
+    // Prefer full Unicode subtables to those limited to the BMP
+    for (int i = 0; i < subtableCount; ++i) {
+        const uint8_t * record = cmap + 4 + (i * 8);
+        if ((size_t)(record + 8 - font->Data) > font->Size) {
+            break;
+        }
+
+        uint16_t platform = DUI_ttU16(record);
+        uint16_t encoding = DUI_ttU16(record + 2);
+        uint32_t offset = font->Cmap + DUI_ttU32(record + 4);
+
+        if ((size_t)offset + 2 > font->Size) {
+            continue;
+        }
+
+        int rank = 0;
+        if (platform == 0 || (platform == 3 && encoding == 10)) {
+            rank = (DUI_ttU16(font->Data + offset) == 12 ? 2 : 1);
+        }
+        else if (platform == 3 && encoding == 1) {
+            rank = 1;
+        }
+
+        if (rank > bestRank) {
+            best = offset;
+            bestRank = rank;
+        }
+    }
+
+    return best;
+}
+
+// Get the index of the glyph for a codepoint, 0 if the font doesn't have one
+int DUI_ttFindGlyph(const DUI_TTFont * font, uint32_t codepoint)
+{
+    uint32_t offset = DUI_ttFindSubtable(font);
+    if (!offset) {
+        return 0;
+    }
+
+    int glyph = DUI_ttLookupSubtable(font, offset, codepoint);
+    return (glyph >= 0 && glyph < font->GlyphCount ? glyph : 0);
+}
+
+// Get the first codepoint from the given one that the cmap has a range for,
+//   or 0x110000 if there are none. Codepoints in a range can still have
+//   no glyph
+uint32_t DUI_ttNextCodepoint(const DUI_TTFont * font, uint32_t codepoint)
+{
+    uint32_t offset = DUI_ttFindSubtable(font);
+    if (!offset) {
+        return 0x110000;
+    }
+
+    const uint8_t * table = font->Data + offset;
+    uint16_t format = DUI_ttU16(table);
+
+    if (format == 4) {
+        if (codepoint > 0xFFFF || (size_t)offset + 14 > font->Size) {
+            return 0x110000;
+        }
+
+        int segmentCount = DUI_ttU16(table + 6) / 2;
+        if ((size_t)offset + 16 + (segmentCount * 8) > font->Size) {
+            return 0x110000;
+        }
+
+        const uint8_t * endCodes = table + 14;
+        const uint8_t * startCodes = endCodes + (segmentCount * 2) + 2;
+
+        for (int i = 0; i < segmentCount; ++i) {
+            if (DUI_ttU16(endCodes + (i * 2)) >= codepoint) {
+                return SDL_max(DUI_ttU16(startCodes + (i * 2)), codepoint);
+            }
+        }
+    }
+
+    if (format == 12) {
+        if ((size_t)offset + 16 > font->Size) {
+            return 0x110000;
+        }
+
+        uint32_t groupCount = DUI_ttU32(table + 12);
+        if ((size_t)offset + 16 + ((size_t)groupCount * 12) > font->Size) {
+            return 0x110000;
+        }
+
+        for (uint32_t i = 0; i < groupCount; ++i) {
+            const uint8_t * group = table + 16 + (i * 12);
+
+            if (DUI_ttU32(group + 4) >= codepoint) {
+                return SDL_max(DUI_ttU32(group), codepoint);
+            }
+        }
+    }
+
+    return 0x110000;
+}
+
+int DUI_ttGetAdvance(const DUI_TTFont * font, int glyph)
+{
+    int metric = SDL_max(SDL_min(glyph, font->HMetricCount - 1), 0);
+    return DUI_ttU16(font->Data + font->Hmtx + (metric * 4));
+}
+
+// Get the location of a glyph's outline, false if it has none
+bool DUI_ttGetGlyphData(const DUI_TTFont * font, int glyph, uint32_t * offset, uint32_t * length)
+{
+    if (glyph < 0 || glyph >= font->GlyphCount) {
+        return false;
+    }
+
+    size_t entrySize = (font->LongOffsets ? 4 : 2);
+    if (font->Loca + ((size_t)(glyph + 2) * entrySize) > font->Size) {
+        return false;
+    }
+
+    uint32_t start, end;
+    if (font->LongOffsets) {
+        start = DUI_ttU32(font->Data + font->Loca + (glyph * 4));
+        end = DUI_ttU32(font->Data + font->Loca + (glyph * 4) + 4);
+    }
+    else {
+        start = DUI_ttU16(font->Data + font->Loca + (glyph * 2)) * 2u;
+        end = DUI_ttU16(font->Data + font->Loca + (glyph * 2) + 2) * 2u;
+    }
+
+    if (end <= start || end - start < 10 || (size_t)font->Glyf + end > font->Size) {
+        return false;
+    }
+
+    *offset = font->Glyf + start;
+    *length = end - start;
+    return true;
+}
+
+// Get the bounds of a glyph in font units, false if it draws nothing
+bool DUI_ttGetGlyphBox(const DUI_TTFont * font, int glyph,
+    int * xMin, int * yMin, int * xMax, int * yMax)
+{
+    uint32_t offset, length;
+    if (!DUI_ttGetGlyphData(font, glyph, &offset, &length)) {
+        return false;
+    }
+
+    const uint8_t * data = font->Data + offset;
+    *xMin = DUI_ttI16(data + 2);
+    *yMin = DUI_ttI16(data + 4);
+    *xMax = DUI_ttI16(data + 6);
+    *yMax = DUI_ttI16(data + 8);
+
+    return (*xMax > *xMin && *yMax > *yMin);
+}
+
+// Accumulate the signed area covered by a line, in bitmap pixels
+void DUI_ttLine(DUI_TTRaster * raster, float x0, float y0, float x1, float y1)
+{
+    if (y0 == y1) {
+        return;
+    }
+
+    float direction = 1.0f;
+    if (y0 > y1) {
+        direction = -1.0f;
+
+        float t = x0; x0 = x1; x1 = t;
+        t = y0; y0 = y1; y1 = t;
+    }
+
+    float dxdy = (x1 - x0) / (y1 - y0);
+    float x = x0;
+
+    if (y0 < 0.0f) {
+        x -= y0 * dxdy;
+    }
+
+    int stride = raster->Width + 2;
+    int yEnd = SDL_min(raster->Height, (int)SDL_ceilf(y1));
+
+    for (int y = SDL_max(0, (int)y0); y < yEnd; ++y) {
+        float * row = raster->Accumulator + (y * stride);
+
+        float dy = SDL_min((float)(y + 1), y1) - SDL_max((float)y, y0);
+        float xNext = x + (dxdy * dy);
+        float d = dy * direction;
+
+        float left = SDL_min(x, xNext);
+        float right = SDL_max(x, xNext);
+
+        // Points are kept inside the bitmap, this only guards against rounding
+        left = SDL_max(0.0f, SDL_min(left, (float)raster->Width));
+        right = SDL_max(0.0f, SDL_min(right, (float)raster->Width));
+
+        float leftFloor = SDL_floorf(left);
+        int leftIndex = (int)leftFloor;
+        float rightCeil = SDL_ceilf(right);
+        int rightIndex = (int)rightCeil;
+
+        if (rightIndex <= leftIndex + 1) {
+            // The line stays within one pixel of this row
+            float middle = ((left + right) * 0.5f) - leftFloor;
+            row[leftIndex] += d - (d * middle);
+            row[leftIndex + 1] += d * middle;
+        }
+        else {
+            float s = 1.0f / (right - left);
+            float leftFraction = left - leftFloor;
+            float a0 = 0.5f * s * (1.0f - leftFraction) * (1.0f - leftFraction);
+            float rightFraction = right - rightCeil + 1.0f;
+            float am = 0.5f * s * rightFraction * rightFraction;
+
+            row[leftIndex] += d * a0;
+
+            if (rightIndex == leftIndex + 2) {
+                row[leftIndex + 1] += d * (1.0f - a0 - am);
+            }
+            else {
+                float a1 = s * (1.5f - leftFraction);
+                row[leftIndex + 1] += d * (a1 - a0);
+
+                for (int i = leftIndex + 2; i < rightIndex - 1; ++i) {
+                    row[i] += d * s;
+                }
+
+                float a2 = a1 + ((rightIndex - leftIndex - 3) * s);
+                row[rightIndex - 1] += d * (1.0f - a2 - am);
+            }
+
+            row[rightIndex] += d * am;
+        }
+
+        x = xNext;
+    }
+}
+
+// Add a quadratic curve as enough lines to be within a fraction of a pixel
+void DUI_ttCurve(DUI_TTRaster * raster, float x0, float y0, float cx, float cy, float x1, float y1)
+{
+    float dx = x0 - (2.0f * cx) + x1;
+    float dy = y0 - (2.0f * cy) + y1;
+    int segments = 1 + (int)SDL_sqrtf(SDL_sqrtf(3.0f * ((dx * dx) + (dy * dy))));
+    segments = SDL_min(segments, 32);
+
+    float px = x0;
+    float py = y0;
+
+    for (int i = 1; i <= segments; ++i) {
+        float t = (float)i / segments;
+        float u = 1.0f - t;
+
+        float x = (u * u * x0) + (2.0f * u * t * cx) + (t * t * x1);
+        float y = (u * u * y0) + (2.0f * u * t * cy) + (t * t * y1);
+
+        DUI_ttLine(raster, px, py, x, y);
+        px = x;
+        py = y;
+    }
+}
+
+// A transform from font units to font units, for composite glyphs
+typedef struct
+{
+    float XX, XY, YX, YY;
+    float DX, DY;
+
+} DUI_TTTransform;
+
+void DUI_ttMapPoint(const DUI_TTRaster * raster, const DUI_TTTransform * transform,
+    float x, float y, float * outX, float * outY)
+{
+    float fx = (transform->XX * x) + (transform->YX * y) + transform->DX;
+    float fy = (transform->XY * x) + (transform->YY * y) + transform->DY;
+
+    // Font units are y up, bitmaps are y down
+    *outX = raster->OriginX + (fx * raster->Scale);
+    *outY = raster->OriginY - (fy * raster->Scale);
+}
+
+bool DUI_ttDrawGlyph(const DUI_TTFont * font, DUI_TTRaster * raster, int glyph,
+    const DUI_TTTransform * transform, int depth);
+
+bool DUI_ttDrawSimpleGlyph(DUI_TTRaster * raster, const uint8_t * data, const uint8_t * end, 
+    int contourCount, const DUI_TTTransform * transform)
+{
+    // Lengths are compared before pointers are formed, so none point past end
+    const uint8_t * endPoints = data + 10;
+    ptrdiff_t available = (end - endPoints) - ((contourCount * 2) + 2);
+    if (available < 0) {
+        return false;
+    }
+
+    int pointCount = DUI_ttU16(endPoints + ((contourCount - 1) * 2)) + 1;
+    int instructionLength = DUI_ttU16(endPoints + (contourCount * 2));
+    if (instructionLength > available) {
+        return false;
+    }
+
+    const uint8_t * p = endPoints + (contourCount * 2) + 2 + instructionLength;
+
+    uint8_t * flags = SDL_malloc(pointCount * sizeof(uint8_t));
+    float * pointsX = SDL_malloc(pointCount * sizeof(float) * 2);
+    if (!flags || !pointsX) {
+        SDL_free(flags);
+        SDL_free(pointsX);
+        return false;
+    }
+
+    float * pointsY = pointsX + pointCount;
+    bool valid = true;
+
+    for (int i = 0; i < pointCount && valid; ) {
+        if (p >= end) {
+            valid = false;
+            break;
+        }
+
+        uint8_t flag = *p++;
+        int repeat = 1;
+
+        if (flag & 0x08) {
+            if (p >= end) {
+                valid = false;
+                break;
+            }
+
+            repeat += *p++;
+        }
+
+        for (; repeat > 0 && i < pointCount; --repeat) {
+            flags[i++] = flag;
+        }
+    }
+
+    // Coordinates are stored as deltas, as a byte with a sign flag, or a
+    //   signed word, or repeated from the previous point
+    int value = 0;
+    for (int i = 0; i < pointCount && valid; ++i) {
+        if (flags[i] & 0x02) {
+            if (p + 1 > end) { valid = false; break; }
+            value += ((flags[i] & 0x10) ? *p : -*p);
+            p += 1;
+        }
+        else if (!(flags[i] & 0x10)) {
+            if (p + 2 > end) { valid = false; break; }
+            value += DUI_ttI16(p);
+            p += 2;
+        }
+
+        pointsX[i] = (float)value;
+    }
+
+    value = 0;
+    for (int i = 0; i < pointCount && valid; ++i) {
+        if (flags[i] & 0x04) {
+            if (p + 1 > end) { valid = false; break; }
+            value += ((flags[i] & 0x20) ? *p : -*p);
+            p += 1;
+        }
+        else if (!(flags[i] & 0x20)) {
+            if (p + 2 > end) { valid = false; break; }
+            value += DUI_ttI16(p);
+            p += 2;
+        }
+
+        pointsY[i] = (float)value;
+    }
+
+    for (int i = 0; i < pointCount && valid; ++i) {
+        DUI_ttMapPoint(raster, transform, pointsX[i], pointsY[i], &pointsX[i], &pointsY[i]);
+    }
+
+    int first = 0;
+    for (int c = 0; c < contourCount && valid; ++c) {
+        int last = DUI_ttU16(endPoints + (c * 2));
+        if (last < first || last >= pointCount) {
+            valid = false;
+            break;
+        }
+
+        int count = last - first + 1;
+
+        // Start from an on curve point, or the midpoint of two off curve points
+        int start = -1;
+        for (int i = 0; i < count; ++i) {
+            if (flags[first + i] & 0x01) {
+                start = i;
+                break;
+            }
+        }
+
+        float startX, startY;
+        if (start >= 0) {
+            startX = pointsX[first + start];
+            startY = pointsY[first + start];
+        }
+        else {
+            start = 0;
+            startX = (pointsX[first] + pointsX[last]) * 0.5f;
+            startY = (pointsY[first] + pointsY[last]) * 0.5f;
+        }
+
+        float x = startX;
+        float y = startY;
+        bool control = false;
+        float cx = 0.0f, cy = 0.0f;
+
+        for (int n = 1; n <= count; ++n) {
+            int i = first + ((start + n) % count);
+            float px = pointsX[i];
+            float py = pointsY[i];
+            bool onCurve = (flags[i] & 0x01);
+
+            // Close the contour back to where it started
+            if (n == count) {
+                px = startX;
+                py = startY;
+                onCurve = true;
+            }
+
+            if (onCurve) {
+                if (control) {
+                    DUI_ttCurve(raster, x, y, cx, cy, px, py);
+                }
+                else {
+                    DUI_ttLine(raster, x, y, px, py);
+                }
+
+                x = px;
+                y = py;
+                control = false;
+            }
+            else {
+                if (control) {
+                    // Two off curve points imply an on curve point between them
+                    float mx = (cx + px) * 0.5f;
+                    float my = (cy + py) * 0.5f;
+                    DUI_ttCurve(raster, x, y, cx, cy, mx, my);
+                    x = mx;
+                    y = my;
+                }
+
+                cx = px;
+                cy = py;
+                control = true;
+            }
+        }
+
+        first = last + 1;
+    }
+
+    SDL_free(pointsX);
+    SDL_free(flags);
+    return valid;
+}
+
+bool DUI_ttDrawCompositeGlyph(const DUI_TTFont * font, DUI_TTRaster * raster,
+    const uint8_t * data, const uint8_t * end, const DUI_TTTransform * transform, int depth)
+{
+    const uint8_t * p = data + 10;
+    uint16_t flags;
+
+    do {
+        if (p + 4 > end) {
+            return false;
+        }
+
+        flags = DUI_ttU16(p);
+        int glyph = DUI_ttU16(p + 2);
+        p += 4;
+
+        float dx, dy;
+        if (flags & 0x0001) {
+            if (p + 4 > end) {
+                return false;
+            }
+
+            dx = DUI_ttI16(p);
+            dy = DUI_ttI16(p + 2);
+            p += 4;
+        }
+        else {
+            if (p + 2 > end) {
+                return false;
+            }
+
+            dx = (int8_t)p[0];
+            dy = (int8_t)p[1];
+            p += 2;
+        }
+
+        // Components positioned by matching points are not supported
+        if (!(flags & 0x0002)) {
+            dx = 0.0f;
+            dy = 0.0f;
+        }
+
+        DUI_TTTransform local = { 1.0f, 0.0f, 0.0f, 1.0f, dx, dy };
+
+        if (flags & 0x0008) {
+            if (p + 2 > end) {
+                return false;
+            }
+
+            local.XX = local.YY = DUI_ttI16(p) / 16384.0f;
+            p += 2;
+        }
+        else if (flags & 0x0040) {
+            if (p + 4 > end) {
+                return false;
+            }
+
+            local.XX = DUI_ttI16(p) / 16384.0f;
+            local.YY = DUI_ttI16(p + 2) / 16384.0f;
+            p += 4;
+        }
+        else if (flags & 0x0080) {
+            if (p + 8 > end) {
+                return false;
+            }
+
+            local.XX = DUI_ttI16(p) / 16384.0f;
+            local.XY = DUI_ttI16(p + 2) / 16384.0f;
+            local.YX = DUI_ttI16(p + 4) / 16384.0f;
+            local.YY = DUI_ttI16(p + 6) / 16384.0f;
+            p += 8;
+        }
+
+        // Apply the component's transform, then the parent's
+        DUI_TTTransform combined = {
+            .XX = (transform->XX * local.XX) + (transform->YX * local.XY),
+            .XY = (transform->XY * local.XX) + (transform->YY * local.XY),
+            .YX = (transform->XX * local.YX) + (transform->YX * local.YY),
+            .YY = (transform->XY * local.YX) + (transform->YY * local.YY),
+            .DX = (transform->XX * local.DX) + (transform->YX * local.DY) + transform->DX,
+            .DY = (transform->XY * local.DX) + (transform->YY * local.DY) + transform->DY,
+        };
+
+        // A component that can't be drawn would leave a partial glyph
+        if (!DUI_ttDrawGlyph(font, raster, glyph, &combined, depth + 1)) {
+            return false;
+        }
+
+    } while (flags & 0x0020);
+
+    return true;
+}
+
+// Draw a glyph's outline into the raster's accumulator
+bool DUI_ttDrawGlyph(const DUI_TTFont * font, DUI_TTRaster * raster, int glyph,
+    const DUI_TTTransform * transform, int depth)
+{
+    if (depth > DUI_TT_MAX_COMPONENT_DEPTH || glyph < 0 || glyph >= font->GlyphCount) {
+        return false;
+    }
+
+    uint32_t offset, length;
+    if (!DUI_ttGetGlyphData(font, glyph, &offset, &length)) {
+        return true;
+    }
+
+    const uint8_t * data = font->Data + offset;
+    const uint8_t * end = data + length;
+    int contourCount = DUI_ttI16(data);
+
+    if (contourCount > 0) {
+        return DUI_ttDrawSimpleGlyph(raster, data, end, contourCount, transform);
+    }
+
+    if (contourCount < 0) {
+        return DUI_ttDrawCompositeGlyph(font, raster, data, end, transform, depth);
+    }
+
+    return true;
+}
+
+// Rasterize a glyph into an 8-bit coverage bitmap of width by height pixels,
+//   with the glyph's origin at (originX, originY)
+bool DUI_ttRasterize(const DUI_TTFont * font, int glyph, float scale,
+    float originX, float originY, uint8_t * pixels, int width, int height)
+{
+    DUI_TTRaster raster = {
+        .Scale = scale,
+        .OriginX = originX,
+        .OriginY = originY,
+        .Width = width,
+        .Height = height,
+    };
+
+    int stride = width + 2;
+    raster.Accumulator = SDL_malloc(stride * height * sizeof(float));
+    if (!raster.Accumulator) {
+        return false;
+    }
+
+    SDL_memset(raster.Accumulator, 0, stride * height * sizeof(float));
+
+    DUI_TTTransform identity = { 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f };
+    bool result = DUI_ttDrawGlyph(font, &raster, glyph, &identity, 0);
+
+    // The coverage of each pixel is the sum of the area to its left
+    for (int y = 0; y < height; ++y) {
+        const float * row = raster.Accumulator + (y * stride);
+        float sum = 0.0f;
+
+        for (int x = 0; x < width; ++x) {
+            sum += row[x];
+            float coverage = SDL_min(SDL_fabsf(sum), 1.0f);
+            pixels[(y * width) + x] = (uint8_t)((coverage * 255.0f) + 0.5f);
+        }
+    }
+
+    SDL_free(raster.Accumulator);
+    return result;
+}
+
+// Distances are squared while they're transformed, so this is far enough 
+//   to mean "no edge found" without overflowing
+#define DUI_TT_FAR (1e20f)
+
+// Replace each value along a row or column with the smallest squared
+//   distance to another value plus its own, from "Distance Transforms of 
+//   Sampled Functions" by Felzenszwalb and Huttenlocher
+//
+// @param f: Scratch space for count floats
+// @param v: Scratch space for count ints
+// @param z: Scratch space for count + 1 floats
+void DUI_ttDistanceTransform(float * grid, int stride, int count, 
+    float * f, int * v, float * z)
+{
+    v[0] = 0;
+    z[0] = -DUI_TT_FAR;
+    z[1] = DUI_TT_FAR;
+    f[0] = grid[0];
+
+    // Find the lower envelope of the parabolas rooted at each value
+    int k = 0;
+    for (int q = 1; q < count; ++q) {
+        f[q] = grid[q * stride];
+
+        float s;
+        do {
+            int r = v[k];
+            s = ((f[q] - f[r]) + (float)((q * q) - (r * r))) / (float)(2 * (q - r));
+        } while (s <= z[k] && --k > -1);
+
+        ++k;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = DUI_TT_FAR;
+    }
+
+    k = 0;
+    for (int q = 0; q < count; ++q) {
+        while (z[k + 1] < q) {
+            ++k;
+        }
+
+        int r = v[k];
+        grid[q * stride] = f[r] + (float)((q - r) * (q - r));
+    }
+}
+
+// Rasterize a glyph into an 8-bit signed distance field, with the glyph's
+//   origin at (originX, originY). A value of 128 is on the outline, and
+//   the value changes by 127 every spread pixels, larger inside the glyph.
+//   The bitmap should be padded by spread pixels on each side
+bool DUI_ttRasterizeSDF(const DUI_TTFont * font, int glyph, float scale,
+    float originX, float originY, float spread, 
+    uint8_t * pixels, int pitch, int width, int height)
+{
+    int count = width * height;
+    int length = SDL_max(width, height);
+
+    uint8_t * coverage = SDL_malloc(count);
+    float * outer = SDL_malloc(count * sizeof(float));
+    float * inner = SDL_malloc(count * sizeof(float));
+    float * f = SDL_malloc(length * sizeof(float));
+    float * z = SDL_malloc((length + 1) * sizeof(float));
+    int * v = SDL_malloc(length * sizeof(int));
+
+    bool result = coverage && outer && inner && f && z && v
+        && DUI_ttRasterize(font, glyph, scale, originX, originY, coverage, width, height);
+
+    if (result) {
+        // Partly covered pixels are treated as being as far from the outline
+        //   as their coverage is from half, which keeps detail smaller
+        //   than a pixel
+        for (int i = 0; i < count; ++i) {
+            float a = coverage[i] / 255.0f;
+
+            if (a >= 1.0f) {
+                outer[i] = 0.0f;
+                inner[i] = DUI_TT_FAR;
+            }
+            else if (a <= 0.0f) {
+                outer[i] = DUI_TT_FAR;
+                inner[i] = 0.0f;
+            }
+            else {
+                float o = SDL_max(0.5f - a, 0.0f);
+                float n = SDL_max(a - 0.5f, 0.0f);
+                outer[i] = o * o;
+                inner[i] = n * n;
+            }
+        }
+
+        for (int x = 0; x < width; ++x) {
+            DUI_ttDistanceTransform(outer + x, width, height, f, v, z);
+            DUI_ttDistanceTransform(inner + x, width, height, f, v, z);
+        }
+
+        for (int y = 0; y < height; ++y) {
+            DUI_ttDistanceTransform(outer + (y * width), 1, width, f, v, z);
+            DUI_ttDistanceTransform(inner + (y * width), 1, width, f, v, z);
+        }
+
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                int i = (y * width) + x;
+                float distance = SDL_sqrtf(inner[i]) - SDL_sqrtf(outer[i]);
+                float value = 128.0f + ((distance / spread) * 127.0f);
+                pixels[(y * pitch) + x] = (uint8_t)SDL_min(SDL_max(value + 0.5f, 0.0f), 255.0f);
+            }
+        }
+    }
+
+    SDL_free(coverage);
+    SDL_free(outer);
+    SDL_free(inner);
+    SDL_free(f);
+    SDL_free(z);
+    SDL_free(v);
+
+    return result;
+}
+
+#endif // DUI_IMPLEMENTATION
+
+#endif // DUI_TRUETYPE_H